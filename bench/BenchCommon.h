@@ -0,0 +1,117 @@
+#pragma once
+
+// Shared helpers for the benchmark executables: latency statistics,
+// table output and (#5) CPU pinning.
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
+#endif
+
+namespace bench {
+
+using Clock = std::chrono::high_resolution_clock;
+
+struct Stats {
+    double mean;
+    double median;
+    double p99;
+    double min;
+    double max;
+};
+
+inline Stats computeStats(std::vector<double>& samples) {
+    if (samples.empty()) return {0, 0, 0, 0, 0};
+    std::sort(samples.begin(), samples.end());
+    double sum = std::accumulate(samples.begin(), samples.end(), 0.0);
+    size_t n = samples.size();
+    return {
+        sum / n,
+        samples[n / 2],
+        samples[static_cast<size_t>(n * 0.99)],
+        samples.front(),
+        samples.back()
+    };
+}
+
+inline void printHeader(const char* label = "Operation") {
+    std::cout << std::left << std::setw(28) << label
+              << std::right
+              << std::setw(10) << "Mean(ns)"
+              << std::setw(10) << "Med(ns)"
+              << std::setw(10) << "P99(ns)"
+              << std::setw(10) << "Min(ns)"
+              << std::setw(10) << "Max(ns)"
+              << "\n";
+    std::cout << std::string(78, '-') << "\n";
+}
+
+inline void printStats(const char* label, Stats s) {
+    std::cout << std::left << std::setw(28) << label
+              << std::right
+              << std::setw(10) << std::fixed << std::setprecision(0) << s.mean
+              << std::setw(10) << s.median
+              << std::setw(10) << s.p99
+              << std::setw(10) << s.min
+              << std::setw(10) << s.max
+              << "\n";
+}
+
+// q in [0, 1]; `sorted` must be sorted ascending and non-empty
+inline double percentile(const std::vector<double>& sorted, double q) {
+    size_t i = static_cast<size_t>(q * static_cast<double>(sorted.size() - 1));
+    return sorted[i];
+}
+
+inline void printPercentileHeader(const char* label = "Operation") {
+    std::cout << std::left << std::setw(14) << label
+              << std::right
+              << std::setw(11) << "Count"
+              << std::setw(10) << "P50(ns)"
+              << std::setw(10) << "P90(ns)"
+              << std::setw(10) << "P99(ns)"
+              << std::setw(11) << "P99.9(ns)"
+              << std::setw(12) << "Max(ns)"
+              << "\n";
+    std::cout << std::string(78, '-') << "\n";
+}
+
+inline void printPercentiles(const char* label, std::vector<double>& samples) {
+    std::cout << std::left << std::setw(14) << label << std::right
+              << std::setw(11) << samples.size();
+    if (samples.empty()) {
+        std::cout << "\n";
+        return;
+    }
+    std::sort(samples.begin(), samples.end());
+    std::cout << std::fixed << std::setprecision(0)
+              << std::setw(10) << percentile(samples, 0.50)
+              << std::setw(10) << percentile(samples, 0.90)
+              << std::setw(10) << percentile(samples, 0.99)
+              << std::setw(11) << percentile(samples, 0.999)
+              << std::setw(12) << samples.back()
+              << "\n";
+}
+
+inline double elapsedNs(Clock::time_point start, Clock::time_point end) {
+    return static_cast<double>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+}
+
+// #5: Pin thread to CPU 0 and elevate process priority
+inline void pinToCpu0() {
+#ifdef _WIN32
+    SetThreadAffinityMask(GetCurrentThread(), 1);
+    SetPriorityClass(GetCurrentProcess(), HIGH_PRIORITY_CLASS);
+#endif
+}
+
+} // namespace bench
@@ -1,63 +1,19 @@
 #include "OrderBook.h"
+#include "BenchCommon.h"
+#include "SharedBook.h"
 
-#include <chrono>
-#include <iostream>
-#include <iomanip>
+#include <memory>
 #include <random>
-#include <vector>
-#include <numeric>
-#include <algorithm>
-
-// #5: CPU pinning and process priority (Windows)
-#ifdef _WIN32
-#define NOMINMAX
-#include <Windows.h>
-#endif
+#include <string>
 
 using namespace orderbook;
-using Clock = std::chrono::high_resolution_clock;
-
-struct Stats {
-    double mean;
-    double median;
-    double p99;
-    double min;
-    double max;
-};
-
-Stats computeStats(std::vector<double>& samples) {
-    std::sort(samples.begin(), samples.end());
-    double sum = std::accumulate(samples.begin(), samples.end(), 0.0);
-    size_t n = samples.size();
-    return {
-        sum / n,
-        samples[n / 2],
-        samples[static_cast<size_t>(n * 0.99)],
-        samples.front(),
-        samples.back()
-    };
-}
-
-void printStats(const char* label, Stats s) {
-    std::cout << std::left << std::setw(28) << label
-              << std::right
-              << std::setw(10) << std::fixed << std::setprecision(0) << s.mean
-              << std::setw(10) << s.median
-              << std::setw(10) << s.p99
-              << std::setw(10) << s.min
-              << std::setw(10) << s.max
-              << "\n";
-}
+using namespace bench;
 
 int main() {
     constexpr int NUM_ORDERS = 500'000;
     constexpr int NUM_LEVELS = 1000;
 
-    // #5: Pin thread to CPU 0 and elevate process priority
-#ifdef _WIN32
-    SetThreadAffinityMask(GetCurrentThread(), 1);
-    SetPriorityClass(GetCurrentProcess(), HIGH_PRIORITY_CLASS);
-#endif
+    pinToCpu0();
 
     std::mt19937 rng(42);
     std::uniform_int_distribution<Price> priceDist(9000, 11000);
@@ -100,15 +56,7 @@ int main() {
                 std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
         }
 
-        std::cout << std::left << std::setw(28) << "Operation"
-                  << std::right
-                  << std::setw(10) << "Mean(ns)"
-                  << std::setw(10) << "Med(ns)"
-                  << std::setw(10) << "P99(ns)"
-                  << std::setw(10) << "Min(ns)"
-                  << std::setw(10) << "Max(ns)"
-                  << "\n";
-        std::cout << std::string(78, '-') << "\n";
+        printHeader();
 
         auto stats = computeStats(latencies);
         printStats("Add Limit Order", stats);
@@ -215,5 +163,257 @@ int main() {
                   << NUM_ORDERS << " orders)\n";
     }
 
+    // --- Benchmark 5: Market-impact queries (vector copy vs level aggregates) ---
+    {
+        constexpr int NUM_QUERIES = 100'000;
+        constexpr Quantity SWEEP_QTY = 50'000;
+        constexpr Price WITHIN_TICKS = 100;
+        OrderBook book;
+
+        for (int i = 0; i < NUM_LEVELS; ++i) {
+            for (int j = 0; j < 10; ++j) {
+                book.addOrder(Side::Sell, OrderType::Limit, 10001 + i, qtyDist(rng));
+                book.addOrder(Side::Buy,  OrderType::Limit, 10000 - i, qtyDist(rng));
+            }
+        }
+
+        std::vector<double> vecVwap, vecWithin, aggVwap, aggWithin;
+        vecVwap.reserve(NUM_QUERIES);
+        vecWithin.reserve(NUM_QUERIES);
+        aggVwap.reserve(NUM_QUERIES);
+        aggWithin.reserve(NUM_QUERIES);
+        volatile double sink = 0;  // keep query results observable
+
+        for (int i = 0; i < NUM_QUERIES; ++i) {
+            // Router-style: pull depth vectors and loop over them
+            auto start = Clock::now();
+            {
+                auto asks = book.getAsks(NUM_LEVELS);
+                Quantity remaining = SWEEP_QTY;
+                int64_t notional = 0;
+                for (const auto& lvl : asks) {
+                    Quantity take = static_cast<Quantity>(std::min<LevelQuantity>(remaining, lvl.totalQuantity));
+                    notional += static_cast<int64_t>(take) * lvl.price;
+                    remaining -= take;
+                    if (remaining == 0) break;
+                }
+                sink = sink + static_cast<double>(notional) / (SWEEP_QTY - remaining);
+            }
+            auto mid = Clock::now();
+            {
+                auto bids = book.getBids(static_cast<size_t>(WITHIN_TICKS) + 1);
+                uint64_t total = 0;
+                Price limit = bids.empty() ? 0 : bids.front().price - WITHIN_TICKS;
+                for (const auto& lvl : bids) {
+                    if (lvl.price < limit) break;
+                    total += lvl.totalQuantity;
+                }
+                sink = sink + static_cast<double>(total);
+            }
+            auto end = Clock::now();
+            vecVwap.push_back(static_cast<double>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(mid - start).count()));
+            vecWithin.push_back(static_cast<double>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(end - mid).count()));
+
+            start = Clock::now();
+            sink = sink + book.estimateBuy(SWEEP_QTY).vwap();
+            mid = Clock::now();
+            sink = sink + static_cast<double>(book.bidQuantityWithin(WITHIN_TICKS));
+            end = Clock::now();
+            aggVwap.push_back(static_cast<double>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(mid - start).count()));
+            aggWithin.push_back(static_cast<double>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(end - mid).count()));
+        }
+
+        std::cout << "\nMarket-impact queries (" << NUM_LEVELS << " levels x 10 orders, "
+                  << "VWAP to buy " << SWEEP_QTY << ", bid qty within "
+                  << WITHIN_TICKS << " ticks)\n";
+        printStats("VWAP via getAsks()", computeStats(vecVwap));
+        printStats("VWAP via estimateBuy()", computeStats(aggVwap));
+        printStats("Depth via getBids()", computeStats(vecWithin));
+        printStats("Depth via bidQuantityWithin", computeStats(aggWithin));
+    }
+
+    // --- Benchmark 6: Deep sweep, per-order fills vs conflated level fills ---
+    {
+        constexpr int SWEEP_LEVELS   = 120;
+        constexpr int BOOK_LEVELS    = 150;
+        constexpr int ORDERS_PER_LVL = 10;
+        constexpr int NUM_SWEEPS     = 2'000;
+        constexpr Quantity SWEEP_QTY = SWEEP_LEVELS * ORDERS_PER_LVL * 100;
+
+        auto runSweeps = [&](FillReporting mode, size_t& bytesOut) {
+            OrderBook book(BOOK_LEVELS * ORDERS_PER_LVL * 2);
+            size_t makerUpdates = 0;
+            book.setFillReporting(mode,
+                [](void* ctx, OrderId, Quantity, Quantity) { ++*static_cast<size_t*>(ctx); },
+                &makerUpdates);
+
+            std::vector<double> latencies;
+            latencies.reserve(NUM_SWEEPS);
+            bytesOut = 0;
+
+            for (int i = 0; i < NUM_SWEEPS; ++i) {
+                for (int lvl = 0; lvl < BOOK_LEVELS; ++lvl) {
+                    for (int j = 0; j < ORDERS_PER_LVL; ++j) {
+                        book.addOrder(Side::Sell, OrderType::Limit, 10001 + lvl, 100);
+                    }
+                }
+
+                auto start = Clock::now();
+                auto r = book.addOrder(Side::Buy, OrderType::Market, 0, SWEEP_QTY);
+                auto end = Clock::now();
+
+                latencies.push_back(static_cast<double>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+                bytesOut += r.fills.size() * sizeof(Fill) + r.levelFills.size() * sizeof(LevelFill);
+
+                // Clear the untouched tail so every sweep sees the same book
+                book.addOrder(Side::Buy, OrderType::Market, 0,
+                              (BOOK_LEVELS - SWEEP_LEVELS) * ORDERS_PER_LVL * 100);
+            }
+            return computeStats(latencies);
+        };
+
+        size_t perOrderBytes = 0, conflatedBytes = 0;
+        auto perOrder  = runSweeps(FillReporting::PerOrder,  perOrderBytes);
+        auto conflated = runSweeps(FillReporting::Conflated, conflatedBytes);
+
+        std::cout << "\nDeep sweep (" << SWEEP_LEVELS << " levels x " << ORDERS_PER_LVL
+                  << " orders per market order)\n";
+        printStats("Sweep, per-order fills", perOrder);
+        printStats("Sweep, conflated fills", conflated);
+        std::cout << "Fill payload per sweep: " << perOrderBytes / NUM_SWEEPS
+                  << " B per-order vs " << conflatedBytes / NUM_SWEEPS << " B conflated\n";
+    }
+
+    // 60% add / 30% cancel / 10% market on a deterministic stream (sections 7-9).
+    // With `participants`, every order gets a random owner and the default
+    // self-trade prevention; the order flow itself is unchanged.
+    auto runMixed = [&]<typename Book>(Book& book, OwnerId participants = 0) {
+        std::mt19937 mixRng(7);
+        std::mt19937 ownerRng(11);
+        auto owner = [&] {
+            OwnerId draw = static_cast<OwnerId>(ownerRng());   // drawn either way: same harness cost
+            return participants ? 1 + draw % participants : NO_OWNER;
+        };
+        std::vector<OrderId> live;
+        live.reserve(NUM_ORDERS);
+        auto start = Clock::now();
+        for (int i = 0; i < NUM_ORDERS; ++i) {
+            Side side = (i % 2 == 0) ? Side::Buy : Side::Sell;
+            int op = i % 10;
+            if (op < 6) {
+                Price p = priceDist(mixRng);
+                p += (side == Side::Buy) ? -50 : 50;
+                live.push_back(book.addOrder(side, OrderType::Limit, p, qtyDist(mixRng), owner()).orderId);
+            } else if (op < 9 && !live.empty()) {
+                size_t k = mixRng() % live.size();
+                book.cancelOrder(live[k]);
+                live[k] = live.back();
+                live.pop_back();
+            } else {
+                book.addOrder(side, OrderType::Market, 0, qtyDist(mixRng), owner());
+            }
+        }
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    };
+
+    // --- Benchmark 7: Instrumentation overhead (NoBookStats vs BookStats) ---
+    {
+        OrderBook plain;
+        InstrumentedOrderBook instrumented;
+        double plainSec = runMixed(plain);
+        double instrSec = runMixed(instrumented);
+
+        std::cout << "\nInstrumentation overhead (60% add / 30% cancel / 10% market, "
+                  << NUM_ORDERS << " ops)\n"
+                  << "  NoBookStats: " << std::setprecision(0) << NUM_ORDERS / plainSec << " ops/sec\n"
+                  << "  BookStats:   " << NUM_ORDERS / instrSec << " ops/sec\n";
+
+        auto snap = instrumented.stats().snapshot();
+        std::cout << "  fills=" << snap.fills << " matches=" << snap.matches
+                  << " bestPriceScans=" << snap.bestPriceScans
+                  << " poolHighWater=" << snap.poolHighWater
+                  << " indexResizes=" << snap.indexResizes << "\n"
+                  << "  levelsScanned log2 buckets:";
+        for (uint64_t c : snap.levelsScanned) std::cout << ' ' << c;
+        std::cout << "\n";
+    }
+
+#ifndef _WIN32
+    // --- Benchmark 8: Shared-memory hosted book, warm restart vs rebuild ---
+    {
+        const std::string name = "/ob_bench_" + std::to_string(getpid());
+        SharedBookSegment seg;
+        if (!SharedBookSegment::create(name, 1'048'576, seg)) {
+            std::cout << "\nShared-memory book: cannot create segment " << name << "\n";
+        } else {
+            OrderBook heap;
+            double heapSec = runMixed(heap);
+            auto shared = std::make_unique<OrderBook>(std::move(seg));
+            double sharedSec = runMixed(*shared);
+            size_t resting = shared->orderCount();
+            shared.reset();   // "crash": the segment outlives the engine
+
+            // Restart by reattaching, or by rebuilding from the journal (replaying
+            // the same stream into a fresh book)
+            auto t0 = Clock::now();
+            SharedBookSegment::open(name, true, seg);
+            shared = std::make_unique<OrderBook>(std::move(seg));
+            auto t1 = Clock::now();
+            OrderBook rebuilt;
+            runMixed(rebuilt);
+            auto t2 = Clock::now();
+
+            std::cout << "\nShared-memory hosted book (mixed stream, " << NUM_ORDERS << " ops)\n"
+                      << "  Heap:   " << std::setprecision(0) << NUM_ORDERS / heapSec << " ops/sec\n"
+                      << "  Shared: " << NUM_ORDERS / sharedSec << " ops/sec\n"
+                      << "  Restart with " << resting << " resting orders: reattach "
+                      << std::setprecision(1) << elapsedNs(t0, t1) / 1e3 << " us, rebuild "
+                      << elapsedNs(t1, t2) / 1e3 << " us\n";
+            if (shared->orderCount() != resting) std::cout << "  REATTACH MISMATCH\n";
+
+            shared.reset();
+            SharedBookSegment::remove(name);
+        }
+    }
+#endif
+
+    // --- Benchmark 9: Self-trade prevention overhead ---
+    {
+        // Same order flow without owners (the check short-circuits) and with
+        // random owners, where every resting order reached is compared.
+        // Best of 5 per configuration.
+        auto best = [&](OwnerId participants) {
+            double sec = 1e30;
+            for (int r = 0; r < 5; ++r) {
+                OrderBook book;
+                sec = std::min(sec, runMixed(book, participants));
+            }
+            return sec;
+        };
+        auto prevented = [&](OwnerId participants) {
+            InstrumentedOrderBook book;
+            runMixed(book, participants);
+            return book.stats().snapshot().selfTrades;
+        };
+
+        std::cout << "\nSelf-trade prevention (mixed stream, " << NUM_ORDERS << " ops)\n";
+        double baseSec = best(0);
+        std::cout << "  No owners:         " << std::setprecision(0) << NUM_ORDERS / baseSec
+                  << " ops/sec\n";
+        for (OwnerId participants : {OwnerId{1000}, OwnerId{8}}) {
+            double sec = best(participants);
+            std::cout << "  " << std::left << std::setw(4) << participants << std::right
+                      << " participants: " << std::setprecision(0) << NUM_ORDERS / sec
+                      << " ops/sec (" << std::showpos << std::setprecision(1)
+                      << 100.0 * (baseSec / sec - 1.0) << std::noshowpos << "%), "
+                      << prevented(participants) << " self-trades prevented\n";
+        }
+    }
+
     return 0;
 }
@@ -0,0 +1,74 @@
+// Writes a synthetic order message file for replay_benchmark.
+//
+//   generate_workload <out.bin> [--messages=N] [--seed=S] [--mid=P]
+//       [--depth-mean=T] [--cancel-ratio=R] [--market-share=R]
+//       [--lifetime-mean=M] [--burst-prob=P] [--burst-len=M] [--max-qty=Q]
+//       [--symbols=N] [--symbol-skew=S]
+
+#include "WorkloadGenerator.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+using namespace orderbook;
+using namespace bench;
+
+namespace {
+
+bool parseOption(const char* arg, WorkloadConfig& cfg) {
+    const char* eq = std::strchr(arg, '=');
+    if (!eq || std::strncmp(arg, "--", 2) != 0) return false;
+    std::string key(arg + 2, eq);
+    const char* value = eq + 1;
+
+    if      (key == "messages")      cfg.messages     = std::strtoull(value, nullptr, 10);
+    else if (key == "seed")          cfg.seed         = std::strtoull(value, nullptr, 10);
+    else if (key == "mid")           cfg.midPrice     = std::strtoll(value, nullptr, 10);
+    else if (key == "depth-mean")    cfg.depthMean    = std::atof(value);
+    else if (key == "cancel-ratio")  cfg.cancelRatio  = std::atof(value);
+    else if (key == "market-share")  cfg.marketShare  = std::atof(value);
+    else if (key == "lifetime-mean") cfg.lifetimeMean = std::atof(value);
+    else if (key == "burst-prob")    cfg.burstProb    = std::atof(value);
+    else if (key == "burst-len")     cfg.burstLenMean = std::atof(value);
+    else if (key == "symbols")       cfg.symbols      = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+    else if (key == "symbol-skew")   cfg.symbolSkew   = std::atof(value);
+    else if (key == "max-qty")       cfg.maxQty       = static_cast<Quantity>(std::strtoul(value, nullptr, 10));
+    else return false;
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "usage: generate_workload <out.bin> [--messages=N] [--seed=S] [--mid=P]\n"
+                     "         [--depth-mean=T] [--cancel-ratio=R] [--market-share=R]\n"
+                     "         [--lifetime-mean=M] [--burst-prob=P] [--burst-len=M] [--max-qty=Q]\n"
+                     "         [--symbols=N] [--symbol-skew=S]\n";
+        return 1;
+    }
+
+    WorkloadConfig cfg;
+    for (int i = 2; i < argc; ++i) {
+        if (!parseOption(argv[i], cfg)) {
+            std::cerr << "unknown option: " << argv[i] << "\n";
+            return 1;
+        }
+    }
+
+    auto messages = generateWorkload(cfg);
+    if (!writeMessageFile(argv[1], messages)) {
+        std::cerr << "failed to write " << argv[1] << "\n";
+        return 1;
+    }
+
+    size_t counts[NUM_MESSAGE_TYPES] = {};
+    for (const auto& m : messages) ++counts[static_cast<size_t>(m.type)];
+    std::cout << "wrote " << messages.size() << " messages to " << argv[1]
+              << " (limit " << counts[0] << ", market " << counts[1]
+              << ", cancel " << counts[2] << ") across " << std::max<uint32_t>(cfg.symbols, 1)
+              << " symbol(s)\n";
+    return 0;
+}
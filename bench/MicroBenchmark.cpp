@@ -0,0 +1,276 @@
+// Per-operation microbenchmarks (Google Benchmark).
+//
+// Every case runs against both price level layouts and is parameterized by
+// book shape. State that an operation consumes (pool slots, resting orders)
+// is rebuilt with timing paused, so each case measures only its operation.
+//
+// Regression check against the checked-in baseline (both from Release builds;
+// the build type is recorded in the JSON context as "build_type"):
+//   microbench --benchmark_out=current.json --benchmark_out_format=json
+//   python3 bench/compare_baseline.py bench/baseline.json current.json --threshold=10
+
+#include "OrderBook.h"
+#include "WorkloadGenerator.h"
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace orderbook;
+
+namespace {
+
+constexpr Price MID = 10'000;
+
+// Rest `depth` levels per side with `perLevel` orders each around MID,
+// owned round-robin by `owners` participants (none if 0).
+template <typename Book>
+std::vector<OrderId> populate(Book& book, int depth, int perLevel, OwnerId owners = 0) {
+    std::vector<OrderId> ids;
+    ids.reserve(static_cast<size_t>(depth) * perLevel * 2);
+    for (int lvl = 0; lvl < depth; ++lvl) {
+        for (int j = 0; j < perLevel; ++j) {
+            OwnerId owner = owners ? 1 + static_cast<OwnerId>(j) % owners : NO_OWNER;
+            ids.push_back(book.addOrder(Side::Sell, OrderType::Limit, MID + 1 + lvl, 100, owner).orderId);
+            ids.push_back(book.addOrder(Side::Buy,  OrderType::Limit, MID - 1 - lvl, 100, owner).orderId);
+        }
+    }
+    return ids;
+}
+
+// args: depth, orders per level, pool size
+template <typename Book>
+void BM_AddLimit(benchmark::State& state) {
+    const int    depth    = static_cast<int>(state.range(0));
+    const int    perLevel = static_cast<int>(state.range(1));
+    const size_t pool     = static_cast<size_t>(state.range(2));
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> levelDist(0, depth - 1);
+    std::vector<Price> prices(4096);
+    for (auto& p : prices) p = MID - 1 - levelDist(rng);
+
+    std::unique_ptr<Book> book;
+    size_t budget = 0;
+    size_t i = 0;
+    for (auto _ : state) {
+        if (budget == 0) [[unlikely]] {
+            state.PauseTiming();
+            book = std::make_unique<Book>(pool);
+            populate(*book, depth, perLevel);
+            budget = pool - book->orderCount() - 1;
+            state.ResumeTiming();
+        }
+        benchmark::DoNotOptimize(
+            book->addOrder(Side::Buy, OrderType::Limit, prices[i++ & 4095], 100));
+        --budget;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// args: depth, orders per level, pool size (unused beyond book capacity)
+template <typename Book>
+void BM_Cancel(benchmark::State& state) {
+    const int    depth    = static_cast<int>(state.range(0));
+    const int    perLevel = static_cast<int>(state.range(1));
+    const size_t pool     = static_cast<size_t>(state.range(2));
+
+    std::mt19937 rng(42);
+    std::unique_ptr<Book> book;
+    std::vector<OrderId> ids;
+    size_t next = 0;
+    for (auto _ : state) {
+        if (next == ids.size()) [[unlikely]] {
+            state.PauseTiming();
+            book = std::make_unique<Book>(pool);
+            ids = populate(*book, depth, perLevel);
+            std::shuffle(ids.begin(), ids.end(), rng);
+            next = 0;
+            state.ResumeTiming();
+        }
+        benchmark::DoNotOptimize(book->cancelOrder(ids[next++]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// args: depth, orders per level, orders swept per market order
+template <typename Book>
+void BM_AggressiveMatch(benchmark::State& state) {
+    const int depth    = static_cast<int>(state.range(0));
+    const int perLevel = static_cast<int>(state.range(1));
+    const int sweep    = static_cast<int>(state.range(2));
+    const size_t resting = static_cast<size_t>(depth) * perLevel;
+
+    std::unique_ptr<Book> book;
+    size_t left = 0;
+    for (auto _ : state) {
+        if (left < static_cast<size_t>(sweep)) [[unlikely]] {
+            state.PauseTiming();
+            book = std::make_unique<Book>(resting * 2 + 16);
+            populate(*book, depth, perLevel);
+            left = resting;
+            state.ResumeTiming();
+        }
+        benchmark::DoNotOptimize(
+            book->addOrder(Side::Buy, OrderType::Market, 0, static_cast<Quantity>(sweep) * 100));
+        left -= static_cast<size_t>(sweep);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Same sweep with self-trade prevention armed: makers belong to 8 owners and
+// the aggressor to a 9th, so every resting order is checked and none is
+// skipped. Compare with BM_AggressiveMatch for the cost of the check.
+// args: depth, orders per level, orders swept per market order
+template <typename Book>
+void BM_AggressiveMatchStp(benchmark::State& state) {
+    const int depth    = static_cast<int>(state.range(0));
+    const int perLevel = static_cast<int>(state.range(1));
+    const int sweep    = static_cast<int>(state.range(2));
+    const size_t resting = static_cast<size_t>(depth) * perLevel;
+    constexpr OwnerId kOwners = 8;
+
+    std::unique_ptr<Book> book;
+    size_t left = 0;
+    for (auto _ : state) {
+        if (left < static_cast<size_t>(sweep)) [[unlikely]] {
+            state.PauseTiming();
+            book = std::make_unique<Book>(resting * 2 + 16);
+            populate(*book, depth, perLevel, kOwners);
+            left = resting;
+            state.ResumeTiming();
+        }
+        benchmark::DoNotOptimize(book->addOrder(Side::Buy, OrderType::Market, 0,
+                                                static_cast<Quantity>(sweep) * 100, kOwners + 1,
+                                                SelfTradePrevention::CancelResting));
+        left -= static_cast<size_t>(sweep);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// args: book depth, levels requested
+template <typename Book>
+void BM_DepthQuery(benchmark::State& state) {
+    const int depth = static_cast<int>(state.range(0));
+    Book book(static_cast<size_t>(depth) * 4 + 16);
+    populate(book, depth, 2);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(book.getBids(static_cast<size_t>(state.range(1))));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// args: book depth, quantity as a multiple of one level
+template <typename Book>
+void BM_EstimateBuy(benchmark::State& state) {
+    const int depth = static_cast<int>(state.range(0));
+    Book book(static_cast<size_t>(depth) * 4 + 16);
+    populate(book, depth, 2);
+    const auto qty = static_cast<Quantity>(state.range(1) * 200);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(book.estimateBuy(qty));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// args: empty ticks between the best ask and the next level.
+// Each iteration rests one order at a new best ask and cancels it, so the
+// cancel has to scan `gap` empty ticks to recover the best price.
+template <typename Book>
+void BM_BestPriceRecovery(benchmark::State& state) {
+    const Price gap = static_cast<Price>(state.range(0));
+    Book book(1024);
+    book.addOrder(Side::Sell, OrderType::Limit, MID + gap + 1, 100);
+
+    for (auto _ : state) {
+        auto r = book.addOrder(Side::Sell, OrderType::Limit, MID, 100);
+        benchmark::DoNotOptimize(book.cancelOrder(r.orderId));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// args: cancel ratio (percent of messages), market share (per mille).
+// Replays a generated stream; the book is rebuilt whenever it runs out.
+template <typename Book>
+void BM_MixedFlow(benchmark::State& state) {
+    bench::WorkloadConfig cfg;
+    cfg.messages    = 200'000;
+    cfg.cancelRatio = static_cast<double>(state.range(0)) / 100.0;
+    cfg.marketShare = static_cast<double>(state.range(1)) / 1000.0;
+    const auto messages = bench::generateWorkload(cfg);
+
+    std::unique_ptr<Book> book;
+    size_t next = messages.size();
+    for (auto _ : state) {
+        if (next == messages.size()) [[unlikely]] {
+            state.PauseTiming();
+            book = std::make_unique<Book>(messages.size() + 1);
+            next = 0;
+            state.ResumeTiming();
+        }
+        const Message& m = messages[next++];
+        switch (m.type) {
+        case MessageType::AddLimit:
+            benchmark::DoNotOptimize(book->addOrder(m.side, OrderType::Limit, m.price, m.quantity));
+            break;
+        case MessageType::AddMarket:
+            benchmark::DoNotOptimize(book->addOrder(m.side, OrderType::Market, 0, m.quantity));
+            break;
+        case MessageType::Cancel:
+            benchmark::DoNotOptimize(book->cancelOrder(static_cast<OrderId>(m.ref)));
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+#define ORDERBOOK_BENCH(fn, ...)                                                   \
+    BENCHMARK_TEMPLATE(fn, OrderBook)->__VA_ARGS__;                                \
+    BENCHMARK_TEMPLATE(fn, PagedOrderBook)->__VA_ARGS__
+
+ORDERBOOK_BENCH(BM_AddLimit,
+    ArgNames({"depth", "perLevel", "pool"})
+    ->Args({10, 1, 1 << 16})->Args({100, 10, 1 << 16})->Args({1000, 10, 1 << 20}));
+
+ORDERBOOK_BENCH(BM_Cancel,
+    ArgNames({"depth", "perLevel", "pool"})
+    ->Args({10, 100, 1 << 12})->Args({100, 10, 1 << 12})->Args({1000, 10, 1 << 15}));
+
+ORDERBOOK_BENCH(BM_AggressiveMatch,
+    ArgNames({"depth", "perLevel", "sweep"})
+    ->Args({100, 10, 1})->Args({100, 10, 25})->Args({1000, 1, 100}));
+
+ORDERBOOK_BENCH(BM_AggressiveMatchStp,
+    ArgNames({"depth", "perLevel", "sweep"})
+    ->Args({100, 10, 1})->Args({100, 10, 25})->Args({1000, 1, 100}));
+
+ORDERBOOK_BENCH(BM_DepthQuery,
+    ArgNames({"depth", "levels"})->Args({100, 10})->Args({1000, 100}));
+
+ORDERBOOK_BENCH(BM_EstimateBuy,
+    ArgNames({"depth", "levels"})->Args({100, 10})->Args({1000, 500}));
+
+ORDERBOOK_BENCH(BM_BestPriceRecovery,
+    ArgNames({"gap"})->Arg(1)->Arg(64)->Arg(1024));
+
+ORDERBOOK_BENCH(BM_MixedFlow,
+    ArgNames({"cancelPct", "marketPermille"})->Args({42, 10})->Args({20, 50}));
+
+} // namespace
+
+#ifndef ORDERBOOK_BUILD_TYPE
+#define ORDERBOOK_BUILD_TYPE ""
+#endif
+
+int main(int argc, char** argv) {
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::AddCustomContext("build_type", ORDERBOOK_BUILD_TYPE[0] ? ORDERBOOK_BUILD_TYPE : "none");
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,157 @@
+// Dense flat-array vs paged price level index across book sparsity.
+//
+// Each side holds ACTIVE_LEVELS populated price levels spread evenly over a
+// band of ACTIVE_LEVELS / sparsity ticks; the sparser the book, the more
+// empty ticks a best-price scan has to skip. The dense index can only
+// represent bands that fit in [MIN_PRICE, MAX_PRICE].
+
+#include "OrderBook.h"
+#include "BenchCommon.h"
+
+#include <random>
+
+using namespace orderbook;
+using namespace bench;
+
+namespace {
+
+constexpr int    ACTIVE_LEVELS = 50;
+constexpr int    RESTING       = 100'000;
+constexpr int    NUM_OPS       = 100'000;
+constexpr size_t POOL          = 400'000;
+
+struct Result {
+    Stats  add;
+    Stats  cancel;
+    Stats  match;
+    size_t levelBytes;
+};
+
+template <typename Book>
+Result run(Price mid, Price step) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int>      levelDist(0, ACTIVE_LEVELS - 1);
+    std::uniform_int_distribution<Quantity> qtyDist(1, 100);
+
+    auto bidPrice = [&] { return mid - 1 - static_cast<Price>(levelDist(rng)) * step; };
+    auto askPrice = [&] { return mid + 1 + static_cast<Price>(levelDist(rng)) * step; };
+
+    Book book(POOL);
+    std::vector<OrderId> ids;
+    ids.reserve(RESTING + NUM_OPS);
+
+    for (int i = 0; i < RESTING; ++i) {
+        Side side = (i % 2 == 0) ? Side::Buy : Side::Sell;
+        Price p = (side == Side::Buy) ? bidPrice() : askPrice();
+        ids.push_back(book.addOrder(side, OrderType::Limit, p, qtyDist(rng)).orderId);
+    }
+
+    Result r{};
+    r.levelBytes = book.levelMemoryBytes();
+
+    std::vector<double> latencies;
+    latencies.reserve(NUM_OPS);
+
+    // Add: non-crossing limit orders on the active levels
+    for (int i = 0; i < NUM_OPS; ++i) {
+        Side side = (i % 2 == 0) ? Side::Buy : Side::Sell;
+        Price p = (side == Side::Buy) ? bidPrice() : askPrice();
+        Quantity q = qtyDist(rng);
+
+        auto start = Clock::now();
+        auto res = book.addOrder(side, OrderType::Limit, p, q);
+        auto end = Clock::now();
+
+        ids.push_back(res.orderId);
+        latencies.push_back(elapsedNs(start, end));
+    }
+    r.add = computeStats(latencies);
+
+    // Cancel: random half of the resting orders, emptying levels along the way
+    std::shuffle(ids.begin(), ids.end(), rng);
+    latencies.clear();
+    for (int i = 0; i < NUM_OPS; ++i) {
+        auto start = Clock::now();
+        book.cancelOrder(ids[static_cast<size_t>(i)]);
+        auto end = Clock::now();
+        latencies.push_back(elapsedNs(start, end));
+    }
+    r.cancel = computeStats(latencies);
+
+    // Match: small market orders, replenished so the book stays populated
+    latencies.clear();
+    for (int i = 0; i < NUM_OPS; ++i) {
+        Side side = (i % 2 == 0) ? Side::Buy : Side::Sell;
+        Side other = (side == Side::Buy) ? Side::Sell : Side::Buy;
+        book.addOrder(other, OrderType::Limit,
+                      (other == Side::Buy) ? bidPrice() : askPrice(), qtyDist(rng));
+
+        Quantity q = qtyDist(rng);
+        auto start = Clock::now();
+        book.addOrder(side, OrderType::Market, 0, q);
+        auto end = Clock::now();
+        latencies.push_back(elapsedNs(start, end));
+    }
+    r.match = computeStats(latencies);
+
+    return r;
+}
+
+void printRow(const char* layout, double sparsity, const Result& r) {
+    std::cout << std::left << std::setw(8) << layout
+              << std::right << std::setw(10) << std::fixed << std::setprecision(3)
+              << sparsity * 100 << "%"
+              << std::setw(12) << std::setprecision(0) << r.add.median
+              << std::setw(9) << r.add.p99
+              << std::setw(12) << r.cancel.median
+              << std::setw(9) << r.cancel.p99
+              << std::setw(12) << r.match.median
+              << std::setw(9) << r.match.p99
+              << std::setw(12) << std::setprecision(1) << r.levelBytes / 1024.0
+              << "\n";
+}
+
+} // namespace
+
+int main() {
+    pinToCpu0();
+
+    // Warm-up
+    run<OrderBook>(MAX_PRICE / 2, 1);
+
+    std::cout << "=== Price Level Index: Dense vs Paged ===\n";
+    std::cout << ACTIVE_LEVELS << " active levels per side, " << RESTING
+              << " resting orders, " << NUM_OPS << " ops per phase\n\n";
+    std::cout << std::left << std::setw(8) << "Layout"
+              << std::right << std::setw(11) << "Occupancy"
+              << std::setw(12) << "Add med" << std::setw(9) << "P99"
+              << std::setw(12) << "Cancel med" << std::setw(9) << "P99"
+              << std::setw(12) << "Match med" << std::setw(9) << "P99"
+              << std::setw(12) << "Levels KiB"
+              << "\n";
+    std::cout << std::string(94, '-') << "\n";
+
+    const Price pagedMid = PagedOrderBook::kMaxPrice / 2;
+
+    for (Price step : {Price{1}, Price{10}, Price{100}, Price{1'000}, Price{10'000}}) {
+        double sparsity = 1.0 / static_cast<double>(step);
+        Price halfBand = ACTIVE_LEVELS * step;
+
+        if (halfBand < (MAX_PRICE - MIN_PRICE) / 2) {
+            printRow("dense", sparsity, run<OrderBook>((MIN_PRICE + MAX_PRICE) / 2, step));
+        } else {
+            std::cout << std::left << std::setw(8) << "dense" << std::right
+                      << std::setw(10) << std::fixed << std::setprecision(3)
+                      << sparsity * 100 << "%   band exceeds [MIN_PRICE, MAX_PRICE]\n";
+        }
+        printRow("paged", sparsity, run<PagedOrderBook>(pagedMid, step));
+    }
+
+    double denseFullRange = 2.0 * static_cast<double>(DenseLevelIndex::bytesFor(
+                                static_cast<size_t>(PagedOrderBook::kMaxPrice + 1)));
+    std::cout << "\nDense layout over the paged range ("
+              << PagedOrderBook::kMaxPrice + 1 << " ticks) would need "
+              << std::setprecision(1) << denseFullRange / (1024.0 * 1024.0) << " MiB\n";
+
+    return 0;
+}
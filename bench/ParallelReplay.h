@@ -0,0 +1,193 @@
+#pragma once
+
+// Parallel replay of multi-symbol message journals.
+//
+// Symbols are independent books, so a journal is partitioned by symbol
+// (each partition keeps its messages contiguous, in input order, with their
+// input sequence numbers) and the partitions are replayed on a small
+// work-stealing pool. Each partition emits its trades tagged with the input
+// sequence of the aggressive message; a k-way merge on that sequence gives
+// the same trade stream as a sequential replay, whatever the scheduling.
+
+#include "MessageFile.h"
+#include "OrderBook.h"
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <numeric>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace bench {
+
+struct SymbolPartition {
+    uint32_t symbol;
+    size_t   adds = 0;                      // sizes the symbol's order pool
+    std::vector<orderbook::Message> messages;
+    std::vector<uint64_t> sequence;         // input index of each message
+};
+
+// One execution, in the order a sequential replay would produce it
+struct Trade {
+    uint64_t           sequence;            // input index of the aggressive message
+    uint32_t           symbol;
+    orderbook::OrderId makerOrderId;
+    orderbook::OrderId takerOrderId;
+    orderbook::Price   price;
+    orderbook::Quantity quantity;
+};
+
+struct PartitionResult {
+    std::vector<Trade> trades;              // ascending sequence
+    size_t restingOrders = 0;               // book state after the last message
+    size_t rejected      = 0;               // invalid messages, not applied (see isValidMessage)
+};
+
+// Partitions in order of first appearance in the input
+inline std::vector<SymbolPartition> partitionBySymbol(const std::vector<orderbook::Message>& messages) {
+    using namespace orderbook;
+
+    std::vector<SymbolPartition> parts;
+    std::unordered_map<uint32_t, size_t> index;
+    for (uint64_t seq = 0; seq < messages.size(); ++seq) {
+        const Message& m = messages[seq];
+        auto [it, inserted] = index.try_emplace(m.symbol, parts.size());
+        if (inserted) {
+            SymbolPartition p;
+            p.symbol = m.symbol;
+            parts.push_back(std::move(p));
+        }
+
+        SymbolPartition& p = parts[it->second];
+        p.messages.push_back(m);
+        p.sequence.push_back(seq);
+        p.adds += (m.type != MessageType::Cancel);
+    }
+    return parts;
+}
+
+inline PartitionResult replayPartition(const SymbolPartition& part) {
+    using namespace orderbook;
+
+    PartitionResult out;
+    OrderBook book(part.adds + 1);
+    for (size_t i = 0; i < part.messages.size(); ++i) {
+        const Message& m = part.messages[i];
+        if (!isValidMessage(m, OrderBook::kMinPrice, OrderBook::kMaxPrice)) [[unlikely]] {
+            ++out.rejected;
+            continue;
+        }
+        if (m.type == MessageType::Cancel) {
+            book.cancelOrder(static_cast<OrderId>(m.ref));
+            continue;
+        }
+        OrderType type = (m.type == MessageType::AddMarket) ? OrderType::Market : OrderType::Limit;
+        OrderResult r = book.addOrder(m.side, type, m.price, m.quantity);
+        for (const Fill& f : r.fills) {
+            out.trades.push_back({part.sequence[i], part.symbol, f.makerOrderId, f.takerOrderId,
+                                  f.price, f.quantity});
+        }
+    }
+    out.restingOrders = book.orderCount();
+    return out;
+}
+
+// Runs task(i) for every i in [0, costs.size()) on `threads` workers. Tasks
+// are dealt round-robin in descending cost order, so each worker starts on
+// the biggest work; a worker takes from the front of its own queue (its
+// largest remaining task) and, once empty, steals from the back of another
+// worker's queue (that worker's smallest), which evens out the tail.
+template <typename Task>
+void runWorkStealing(const std::vector<size_t>& costs, unsigned threads, Task&& task) {
+    threads = std::max(1u, std::min<unsigned>(threads, static_cast<unsigned>(costs.size())));
+
+    std::vector<size_t> byCost(costs.size());
+    std::iota(byCost.begin(), byCost.end(), size_t{0});
+    std::stable_sort(byCost.begin(), byCost.end(),
+                     [&](size_t a, size_t b) { return costs[a] > costs[b]; });
+
+    struct Queue {
+        std::mutex         mutex;
+        std::deque<size_t> tasks;
+    };
+    std::vector<Queue> queues(threads);
+    for (size_t i = 0; i < byCost.size(); ++i) queues[i % threads].tasks.push_back(byCost[i]);
+
+    auto take = [&](unsigned self, size_t& out) {
+        {
+            std::lock_guard lock(queues[self].mutex);
+            if (!queues[self].tasks.empty()) {
+                out = queues[self].tasks.front();
+                queues[self].tasks.pop_front();
+                return true;
+            }
+        }
+        // No task is ever added after dealing, so all queues empty means done
+        for (unsigned k = 1; k < threads; ++k) {
+            Queue& victim = queues[(self + k) % threads];
+            std::lock_guard lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                out = victim.tasks.back();
+                victim.tasks.pop_back();
+                return true;
+            }
+        }
+        return false;
+    };
+
+    auto worker = [&](unsigned self) {
+        for (size_t t; take(self, t);) task(t);
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (unsigned w = 1; w < threads; ++w) pool.emplace_back(worker, w);
+    worker(0);
+    for (auto& t : pool) t.join();
+}
+
+// K-way merge of per-partition trade streams on input sequence. Sequences
+// never collide across partitions (one message belongs to one symbol) and
+// trades of one message keep their partition order.
+inline std::vector<Trade> mergeTrades(const std::vector<PartitionResult>& results) {
+    using Cursor = std::pair<uint64_t, size_t>;   // (next sequence, partition)
+    std::priority_queue<Cursor, std::vector<Cursor>, std::greater<>> heap;
+    std::vector<size_t> pos(results.size(), 0);
+
+    size_t total = 0;
+    for (size_t p = 0; p < results.size(); ++p) {
+        total += results[p].trades.size();
+        if (!results[p].trades.empty()) heap.push({results[p].trades[0].sequence, p});
+    }
+
+    std::vector<Trade> merged;
+    merged.reserve(total);
+    while (!heap.empty()) {
+        auto [seq, p] = heap.top();
+        heap.pop();
+        const auto& trades = results[p].trades;
+        size_t& i = pos[p];
+        while (i < trades.size() && trades[i].sequence == seq) merged.push_back(trades[i++]);
+        if (i < trades.size()) heap.push({trades[i].sequence, p});
+    }
+    return merged;
+}
+
+// Replays every partition on `threads` workers; results are indexed like
+// `parts`, independent of which worker ran what
+inline std::vector<PartitionResult> replayParallel(const std::vector<SymbolPartition>& parts,
+                                                   unsigned threads) {
+    std::vector<size_t> costs(parts.size());
+    for (size_t i = 0; i < parts.size(); ++i) costs[i] = parts[i].messages.size();
+
+    std::vector<PartitionResult> results(parts.size());
+    runWorkStealing(costs, threads, [&](size_t i) { results[i] = replayPartition(parts[i]); });
+    return results;
+}
+
+} // namespace bench
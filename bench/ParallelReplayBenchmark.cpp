@@ -0,0 +1,156 @@
+// Replays a multi-symbol message file with one book per symbol on 1..N
+// worker threads and reports scaling. The merged trade stream is checked to
+// be identical for every thread count.
+//
+//   parallel_replay [file.bin] [--threads=N] [--repeat=R]
+//
+// Without a file, a default 500-symbol stream is generated in memory.
+// Thread counts run 1, 2, 4, ... up to N (default: hardware concurrency).
+
+#include "BenchCommon.h"
+#include "MessageFile.h"
+#include "ParallelReplay.h"
+#include "WorkloadGenerator.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+using namespace orderbook;
+using namespace bench;
+
+namespace {
+
+uint64_t checksum(const std::vector<Trade>& trades) {
+    uint64_t h = 1469598103934665603ull;   // FNV-1a over the fields
+    auto mix = [&h](uint64_t v) { h = (h ^ v) * 1099511628211ull; };
+    for (const Trade& t : trades) {
+        mix(t.sequence);
+        mix(t.symbol);
+        mix(t.makerOrderId);
+        mix(t.takerOrderId);
+        mix(static_cast<uint64_t>(t.price));
+        mix(t.quantity);
+    }
+    return h;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const char* path = nullptr;
+    unsigned maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    int repeat = 3;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--threads=", 10) == 0) {
+            maxThreads = std::max(1u, static_cast<unsigned>(std::strtoul(argv[i] + 10, nullptr, 10)));
+        } else if (std::strncmp(argv[i], "--repeat=", 9) == 0) {
+            repeat = std::max(1, std::atoi(argv[i] + 9));
+        } else if (argv[i][0] != '-') {
+            path = argv[i];
+        } else {
+            std::cerr << "usage: parallel_replay [file.bin] [--threads=N] [--repeat=R]\n";
+            return 1;
+        }
+    }
+
+    std::vector<Message> messages;
+    if (path) {
+        if (!readMessageFile(path, messages)) {
+            std::cerr << "failed to read message file " << path << "\n";
+            return 1;
+        }
+    } else {
+        WorkloadConfig cfg;
+        cfg.messages = 2'000'000;
+        cfg.symbols  = 500;
+        messages = generateWorkload(cfg);
+    }
+
+    // Refuse the journal rather than skip records: dropping an add would
+    // shift the OrderIds every later Cancel of that symbol refers to
+    auto bad = std::find_if(messages.begin(), messages.end(), [](const Message& m) {
+        return !isValidMessage(m, MIN_PRICE, MAX_PRICE);
+    });
+    if (bad != messages.end()) {
+        std::cerr << "message " << (bad - messages.begin())
+                  << " has an unknown type or side, or a price outside ["
+                  << MIN_PRICE << ", " << MAX_PRICE << "]\n";
+        return 1;
+    }
+
+    auto partStart = Clock::now();
+    auto parts = partitionBySymbol(messages);
+    double partSec = elapsedNs(partStart, Clock::now()) / 1e9;
+
+    size_t largest = 0;
+    for (const auto& p : parts) largest = std::max(largest, p.messages.size());
+
+    std::cout << "=== Parallel Replay Benchmark ===\n";
+    std::cout << "Messages: " << messages.size() << (path ? " from " : " (generated)")
+              << (path ? path : "") << ", symbols: " << parts.size()
+              << ", largest symbol: " << largest << " msgs ("
+              << std::fixed << std::setprecision(1)
+              << 100.0 * static_cast<double>(largest) / std::max<size_t>(messages.size(), 1)
+              << "%)\n";
+    std::cout << "Partition: " << std::setprecision(3) << partSec << " sec\n\n";
+
+    std::cout << std::left << std::setw(9) << "Threads" << std::right
+              << std::setw(12) << "Replay(s)"
+              << std::setw(11) << "Merge(s)"
+              << std::setw(14) << "Msgs/sec"
+              << std::setw(10) << "Speedup"
+              << std::setw(12) << "Efficiency"
+              << std::setw(10) << "Trades"
+              << "\n";
+    std::cout << std::string(78, '-') << "\n";
+
+    std::vector<unsigned> counts;
+    for (unsigned t = 1; t < maxThreads; t *= 2) counts.push_back(t);
+    counts.push_back(maxThreads);
+
+    double baseSec = 0;
+    uint64_t reference = 0;
+    bool consistent = true;
+
+    for (unsigned threads : counts) {
+        // Best of `repeat` runs; the first also serves as warm-up
+        double replaySec = 1e30, mergeSec = 1e30;
+        std::vector<Trade> trades;
+        for (int r = 0; r < repeat; ++r) {
+            auto start = Clock::now();
+            auto results = replayParallel(parts, threads);
+            auto mid = Clock::now();
+            trades = mergeTrades(results);
+            auto end = Clock::now();
+            replaySec = std::min(replaySec, elapsedNs(start, mid) / 1e9);
+            mergeSec  = std::min(mergeSec, elapsedNs(mid, end) / 1e9);
+        }
+
+        uint64_t sum = checksum(trades);
+        if (threads == 1) {
+            baseSec   = replaySec;
+            reference = sum;
+        } else if (sum != reference) {
+            consistent = false;
+        }
+
+        double speedup = baseSec / replaySec;
+        std::cout << std::left << std::setw(9) << threads << std::right << std::fixed
+                  << std::setprecision(3)
+                  << std::setw(12) << replaySec
+                  << std::setw(11) << mergeSec
+                  << std::setprecision(0)
+                  << std::setw(14) << messages.size() / (replaySec + mergeSec)
+                  << std::setprecision(2)
+                  << std::setw(9) << speedup << "x"
+                  << std::setw(11) << 100.0 * speedup / threads << "%"
+                  << std::setw(10) << trades.size()
+                  << "\n";
+    }
+
+    std::cout << "\nMerged trade stream " << (consistent ? "identical" : "DIFFERS")
+              << " across thread counts (checksum " << std::hex << reference << std::dec << ")\n";
+    return consistent ? 0 : 1;
+}
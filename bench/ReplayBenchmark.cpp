@@ -0,0 +1,115 @@
+// Replays an order message file (see MessageFile.h) through OrderBook and
+// reports throughput plus latency percentiles per message type.
+//
+//   replay_benchmark [file.bin]
+//
+// Without a file, a default WorkloadConfig stream is generated in memory.
+// Only symbol 0 is replayed.
+
+#include "OrderBook.h"
+#include "BenchCommon.h"
+#include "MessageFile.h"
+#include "WorkloadGenerator.h"
+
+using namespace orderbook;
+using namespace bench;
+
+namespace {
+
+const char* MESSAGE_TYPE_NAMES[NUM_MESSAGE_TYPES] = {"Add Limit", "Add Market", "Cancel"};
+
+size_t countAdds(const std::vector<Message>& messages) {
+    size_t adds = 0;
+    for (const auto& m : messages) adds += (m.type != MessageType::Cancel);
+    return adds;
+}
+
+inline void apply(OrderBook& book, const Message& m) {
+    switch (m.type) {
+    case MessageType::AddLimit:
+        book.addOrder(m.side, OrderType::Limit, m.price, m.quantity);
+        break;
+    case MessageType::AddMarket:
+        book.addOrder(m.side, OrderType::Market, 0, m.quantity);
+        break;
+    case MessageType::Cancel:
+        book.cancelOrder(static_cast<OrderId>(m.ref));
+        break;
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    pinToCpu0();
+
+    std::vector<Message> messages;
+    if (argc > 1) {
+        if (!readMessageFile(argv[1], messages)) {
+            std::cerr << "failed to read message file " << argv[1] << "\n";
+            return 1;
+        }
+    } else {
+        messages = generateWorkload(WorkloadConfig{});
+    }
+    std::erase_if(messages, [](const Message& m) { return m.symbol != 0; });
+
+    // Refuse the journal rather than skip records: dropping an add would
+    // shift the OrderIds every later Cancel refers to
+    auto bad = std::find_if(messages.begin(), messages.end(), [](const Message& m) {
+        return !isValidMessage(m, MIN_PRICE, MAX_PRICE);
+    });
+    if (bad != messages.end()) {
+        std::cerr << "message " << (bad - messages.begin())
+                  << " of symbol 0 has an unknown type or side, or a price outside ["
+                  << MIN_PRICE << ", " << MAX_PRICE << "]\n";
+        return 1;
+    }
+
+    const size_t poolCapacity = countAdds(messages) + 1;
+
+    std::cout << "=== Replay Benchmark ===\n";
+    std::cout << "Messages: " << messages.size()
+              << (argc > 1 ? " from " : " (generated)") << (argc > 1 ? argv[1] : "") << "\n\n";
+
+    // Warm-up pass
+    {
+        OrderBook warmup(poolCapacity);
+        for (const auto& m : messages) apply(warmup, m);
+    }
+
+    // Throughput: untimed inner loop
+    {
+        OrderBook book(poolCapacity);
+        auto start = Clock::now();
+        for (const auto& m : messages) apply(book, m);
+        double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+        std::cout << "Throughput: " << std::fixed << std::setprecision(0)
+                  << messages.size() / elapsed << " msgs/sec ("
+                  << std::setprecision(3) << elapsed << " sec)\n\n";
+    }
+
+    // Latency: per-message timing, bucketed by type
+    {
+        OrderBook book(poolCapacity);
+        std::vector<double> latencies[NUM_MESSAGE_TYPES];
+        for (auto& v : latencies) v.reserve(messages.size());
+
+        for (const auto& m : messages) {
+            auto start = Clock::now();
+            apply(book, m);
+            auto end = Clock::now();
+            latencies[static_cast<size_t>(m.type)].push_back(elapsedNs(start, end));
+        }
+
+        printPercentileHeader("Message");
+        for (size_t t = 0; t < NUM_MESSAGE_TYPES; ++t) {
+            printPercentiles(MESSAGE_TYPE_NAMES[t], latencies[t]);
+        }
+        std::cout << "\nFinal book: " << book.orderCount() << " orders, "
+                  << book.bidLevelCount() << " bid / " << book.askLevelCount() << " ask levels\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,183 @@
+#pragma once
+
+// Synthetic order flow shaped like a live feed: mostly adds and cancels
+// near the touch, short order lifetimes, and occasional bursts of
+// aggressive orders that sweep one side.
+//
+// Each resting limit draws an exponential lifetime (lifetimeMean, counted in
+// messages) and is cancelled at the first message slot after it runs out,
+// unless it trades first. The cancel share therefore follows from the
+// lifetimes and the fill rate (about 0.46 with the defaults). cancelRatio
+// caps it: a slot becomes a cancel only with that probability, so with a cap
+// below the rate at which orders come due they queue, live longer than drawn
+// and the book deepens over the run.
+//
+// The generator drives a real OrderBook with the stream it emits, so every
+// Cancel targets an order that is still resting at that point and OrderIds
+// line up with what a replaying book will assign.
+//
+// With `symbols` > 1 the messages are spread over symbols with Zipf-like
+// activity (symbol k gets a share proportional to 1 / (k + 1)^skew), each
+// symbol generated independently and the streams randomly interleaved.
+
+#include "MessageFile.h"
+#include "OrderBook.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <queue>
+#include <random>
+#include <vector>
+
+namespace bench {
+
+struct WorkloadConfig {
+    size_t   messages     = 1'000'000;
+    uint64_t seed         = 42;
+    uint32_t symbol       = 0;       // first symbol id
+    uint32_t symbols      = 1;
+    double   symbolSkew   = 1.0;     // Zipf exponent of per-symbol activity
+    orderbook::Price midPrice = 10'000;
+
+    double depthMean      = 4.0;     // mean distance of new limits from mid, in ticks
+    double cancelRatio    = 1.0;     // cap on the share of cancels; 1 = lifetimes alone (see above)
+    double marketShare    = 0.01;    // share of market orders outside bursts
+    double lifetimeMean   = 50.0;    // mean resting lifetime in messages before a cancel
+    double burstProb      = 0.002;   // chance per message that an aggressive burst starts
+    double burstLenMean   = 20.0;    // mean messages per burst
+    orderbook::Quantity maxQty = 100;
+};
+
+// One symbol's stream (cfg.symbol), ignoring cfg.symbols
+inline std::vector<orderbook::Message> generateSymbolWorkload(const WorkloadConfig& cfg) {
+    using namespace orderbook;
+
+    std::mt19937_64 rng(cfg.seed);
+    std::uniform_real_distribution<double> uni(0.0, 1.0);
+    std::geometric_distribution<Price> depthDist(1.0 / (1.0 + cfg.depthMean));
+    std::exponential_distribution<double> lifetimeDist(1.0 / cfg.lifetimeMean);
+    std::geometric_distribution<int> burstLenDist(1.0 / cfg.burstLenMean);
+    std::uniform_int_distribution<Quantity> qtyDist(1, cfg.maxQty);
+
+    // (expiry, OrderId), earliest expiry on top
+    using Pending = std::pair<double, OrderId>;
+    std::priority_queue<Pending, std::vector<Pending>, std::greater<>> expiries;
+
+    OrderBook book(cfg.messages + 1);
+    std::vector<Message> out;
+    out.reserve(cfg.messages);
+
+    // Cancel the earliest order whose lifetime has run out, dropping entries
+    // for orders that have since traded away; false if none is due
+    auto cancelDue = [&](double now, Message& m) {
+        while (!expiries.empty() && expiries.top().first <= now) {
+            OrderId ref = expiries.top().second;
+            expiries.pop();
+            if (book.cancelOrder(ref)) {
+                m.type = MessageType::Cancel;
+                m.ref  = ref;
+                return true;
+            }
+        }
+        return false;
+    };
+
+    const Price lowMid  = MIN_PRICE + 1'000;
+    const Price highMid = MAX_PRICE - 1'000;
+    Price mid = cfg.midPrice;
+    int   burstLeft = 0;
+    Side  burstSide = Side::Buy;
+
+    while (out.size() < cfg.messages) {
+        const double now = static_cast<double>(out.size());
+        Message m{};
+        m.symbol = cfg.symbol;
+        m.side   = (uni(rng) < 0.5) ? Side::Buy : Side::Sell;
+
+        if (burstLeft == 0 && uni(rng) < cfg.burstProb) {
+            burstLeft = 1 + burstLenDist(rng);
+            burstSide = m.side;
+        }
+
+        double u = uni(rng);
+        if (burstLeft > 0) {
+            // Aggressive burst: one-directional market orders and marketable limits
+            --burstLeft;
+            m.side = burstSide;
+            if (u < 0.5) {
+                m.type = MessageType::AddMarket;
+            } else {
+                m.type  = MessageType::AddLimit;
+                m.price = mid + ((burstSide == Side::Buy) ? 1 : -1) * (1 + depthDist(rng));
+            }
+            m.quantity = qtyDist(rng) * 3;
+        } else if (u < cfg.marketShare) {
+            m.type     = MessageType::AddMarket;
+            m.quantity = qtyDist(rng);
+        } else if (u < cfg.marketShare + cfg.cancelRatio && cancelDue(now, m)) {
+            out.push_back(m);
+            continue;
+        } else {
+            m.type     = MessageType::AddLimit;
+            m.price    = mid + ((m.side == Side::Buy) ? -1 : 1) * (1 + depthDist(rng));
+            m.quantity = qtyDist(rng);
+        }
+
+        m.price = std::clamp(m.price, MIN_PRICE, MAX_PRICE);
+        auto r = book.addOrder(m.side, m.type == MessageType::AddMarket ? OrderType::Market
+                                                                        : OrderType::Limit,
+                               m.price, m.quantity);
+        if (m.type == MessageType::AddLimit && r.remainingQuantity > 0) {
+            expiries.push({now + lifetimeDist(rng), r.orderId});
+        }
+        out.push_back(m);
+
+        // Slow random walk of the mid, nudged along by aggressive flow
+        if (uni(rng) < 0.01 || (burstLeft > 0 && uni(rng) < 0.2)) {
+            Price step = (burstLeft > 0) ? ((burstSide == Side::Buy) ? 1 : -1)
+                                         : ((uni(rng) < 0.5) ? 1 : -1);
+            mid = std::clamp(mid + step, lowMid, highMid);
+        }
+    }
+
+    return out;
+}
+
+inline std::vector<orderbook::Message> generateWorkload(const WorkloadConfig& cfg) {
+    using namespace orderbook;
+
+    if (cfg.symbols <= 1) return generateSymbolWorkload(cfg);
+
+    std::vector<double> weights(cfg.symbols);
+    for (uint32_t k = 0; k < cfg.symbols; ++k) {
+        weights[k] = 1.0 / std::pow(static_cast<double>(k + 1), cfg.symbolSkew);
+    }
+    double totalWeight = std::accumulate(weights.begin(), weights.end(), 0.0);
+
+    // Per-symbol streams, plus one tag per message naming whose turn it is
+    std::vector<std::vector<Message>> streams(cfg.symbols);
+    std::vector<uint32_t> order;
+    order.reserve(cfg.messages + cfg.symbols);
+    for (uint32_t k = 0; k < cfg.symbols; ++k) {
+        WorkloadConfig sub = cfg;
+        sub.symbol   = cfg.symbol + k;
+        sub.seed     = cfg.seed + k;
+        sub.messages = std::max<size_t>(1, static_cast<size_t>(
+            static_cast<double>(cfg.messages) * weights[k] / totalWeight));
+        streams[k] = generateSymbolWorkload(sub);
+        order.insert(order.end(), streams[k].size(), k);
+    }
+
+    // Random interleave that keeps each symbol's messages in order
+    std::mt19937_64 rng(cfg.seed);
+    std::shuffle(order.begin(), order.end(), rng);
+
+    std::vector<Message> out;
+    out.reserve(order.size());
+    std::vector<size_t> next(cfg.symbols, 0);
+    for (uint32_t k : order) out.push_back(streams[k][next[k]++]);
+    return out;
+}
+
+} // namespace bench
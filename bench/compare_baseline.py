@@ -0,0 +1,125 @@
+#!/usr/bin/env python3
+"""Compare a microbench JSON run against the checked-in baseline.
+
+Usage:
+    microbench --benchmark_out=current.json --benchmark_out_format=json
+    python3 bench/compare_baseline.py bench/baseline.json current.json [--threshold=10] [--metric=cpu_time]
+                                      [--filter=REGEX]
+
+A case whose time per iteration grew by more than --threshold percent is
+flagged and the script exits with status 1. So it does when the two files
+cover different cases: a baseline case missing from the current run (renamed,
+deleted or filtered out) or a current case with no baseline entry (a newly
+added benchmark needs the baseline regenerated). For a partial run, pass the
+run's --benchmark_filter as --filter; only baseline cases it matches are
+expected.
+When a file contains repeated runs (--benchmark_repetitions), the median
+aggregate is used.
+
+Both files should come from Release builds. microbench records its build
+type in the JSON context ("build_type"); files from different build types
+are refused unless --allow-build-mismatch is given, and a Google Benchmark
+library that reports itself as a debug build is warned about.
+"""
+
+import argparse
+import json
+import re
+import sys
+
+
+def load(path, metric):
+    with open(path) as f:
+        data = json.load(f)
+    context = data.get("context", {})
+
+    iterations, medians = {}, {}
+    for b in data.get("benchmarks", []):
+        if b.get("run_type") == "aggregate":
+            if b.get("aggregate_name") == "median":
+                medians[b["run_name"]] = b[metric]
+        else:
+            iterations.setdefault(b.get("run_name", b["name"]), b[metric])
+    return medians or iterations, context
+
+
+def check_builds(base_ctx, curr_ctx, allow_mismatch):
+    """False if the two runs come from different microbench build types."""
+    for label, ctx in (("baseline", base_ctx), ("current", curr_ctx)):
+        if ctx.get("library_build_type") == "debug":
+            print(f"warning: {label} was run against a debug Google Benchmark library",
+                  file=sys.stderr)
+    base_type = base_ctx.get("build_type", "unknown")
+    curr_type = curr_ctx.get("build_type", "unknown")
+    if base_type != curr_type:
+        print(f"{'warning' if allow_mismatch else 'error'}: baseline build type "
+              f"{base_type!r} differs from current {curr_type!r}", file=sys.stderr)
+        return allow_mismatch
+    return True
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=10.0,
+                        help="allowed slowdown in percent (default: 10)")
+    parser.add_argument("--metric", default="cpu_time", choices=["cpu_time", "real_time"])
+    parser.add_argument("--allow-build-mismatch", action="store_true",
+                        help="compare even if the build types differ")
+    parser.add_argument("--filter", type=re.compile, default=None,
+                        help="the current run's --benchmark_filter; other baseline cases are skipped")
+    args = parser.parse_args()
+
+    base, base_ctx = load(args.baseline, args.metric)
+    curr, curr_ctx = load(args.current, args.metric)
+    if not check_builds(base_ctx, curr_ctx, args.allow_build_mismatch):
+        return 2
+    if args.filter:
+        base = {name: t for name, t in base.items() if args.filter.search(name)}
+
+    width = max((len(n) for n in base), default=20)
+    print(f"{'Benchmark':<{width}} {'Baseline':>12} {'Current':>12} {'Delta':>9}")
+    print("-" * (width + 36))
+
+    regressions, missing = [], []
+    for name, before in base.items():
+        after = curr.get(name)
+        if after is None:
+            print(f"{name:<{width}} {before:>12.1f} {'missing':>12}")
+            missing.append(name)
+            continue
+        delta = (after - before) / before * 100.0 if before else 0.0
+        flag = ""
+        if delta > args.threshold:
+            flag = "  REGRESSION"
+            regressions.append((name, delta))
+        print(f"{name:<{width}} {before:>12.1f} {after:>12.1f} {delta:>+8.1f}%{flag}")
+
+    uncovered = sorted(curr.keys() - base.keys())
+    for name in uncovered:
+        print(f"{name:<{width}} {'new':>12} {curr[name]:>12.1f}")
+
+    if regressions:
+        print(f"\n{len(regressions)} case(s) slower than baseline by more than "
+              f"{args.threshold:.0f}%:")
+        for name, delta in regressions:
+            print(f"  {name}: {delta:+.1f}%")
+
+    # Cases on only one side are never checked: a dropped benchmark hides its
+    # regressions, a new one needs the baseline regenerated
+    if missing:
+        print(f"\n{len(missing)} baseline case(s) missing from the current run "
+              f"(pass --filter for a partial run).")
+    if uncovered:
+        print(f"\n{len(uncovered)} case(s) missing from the baseline; regenerate it.")
+    if regressions or missing or uncovered:
+        return 1
+
+    print(f"\nNo regressions beyond {args.threshold:.0f}%.")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
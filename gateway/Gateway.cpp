@@ -0,0 +1,552 @@
+// Order entry gateway: serves one OrderBook to any number of clients over
+// TCP or a Unix socket using the binary protocol in Protocol.h.
+//
+//   gateway [--listen=127.0.0.1:9000 | --listen=unix:/tmp/orderbook.sock]
+//           [--capacity=N]
+//
+// Single-threaded, level-triggered epoll loop. Each wakeup:
+//   1. reads every readable connection (one read() returns many messages)
+//      and decodes complete messages into one request batch,
+//   2. runs the whole batch through the book, appending replies to a batch
+//      arena and recording per-connection (offset, length) spans,
+//   3. flushes each connection with one writev() gathering its spans.
+// Replies a socket cannot take yet are copied to that connection's backlog
+// and sent on EPOLLOUT. A client that stops reading is pushed back on: past
+// BACKLOG_PAUSE_BYTES unsent its requests are no longer read until the
+// backlog drains below BACKLOG_RESUME_BYTES, and since fills for its resting
+// orders keep arriving meanwhile, past BACKLOG_LIMIT_BYTES it is closed.
+// Resting orders survive their connection closing.
+
+#include "OrderBook.h"
+#include "Protocol.h"
+#include "Socket.h"
+
+#include <sys/epoll.h>
+#include <sys/uio.h>
+
+#include <algorithm>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace orderbook;
+using namespace orderbook::gateway;
+
+namespace {
+
+volatile std::sig_atomic_t stopRequested = 0;
+
+void onSignal(int) { stopRequested = 1; }
+
+constexpr size_t   READ_BUFFER_BYTES  = 64 * 1024;
+constexpr int      MAX_EVENTS         = 256;
+constexpr int      MAX_READS_PER_WAKE = 4;      // bound one client's share of a batch
+constexpr uint64_t LISTENER_ID        = 0;
+
+// Per-connection unsent reply bytes (see the file header)
+constexpr size_t   BACKLOG_PAUSE_BYTES  = 1 << 20;
+constexpr size_t   BACKLOG_RESUME_BYTES = 256 * 1024;
+constexpr size_t   BACKLOG_LIMIT_BYTES  = 64 << 20;
+
+struct Span {
+    uint32_t offset;
+    uint32_t length;
+};
+
+struct Connection {
+    uint32_t           id = 0;
+    int                fd = -1;
+    std::vector<char>  in = std::vector<char>(READ_BUFFER_BYTES);
+    size_t             inLen = 0;
+    std::vector<Span>  replies;        // this batch, into Gateway::arena_
+    std::vector<char>  backlog;        // bytes an earlier flush could not send
+    size_t             backlogSent = 0;
+    bool               paused = false; // input not read until the backlog drains
+    uint32_t           interest = EPOLLIN;
+
+    size_t unsent() const { return backlog.size() - backlogSent; }
+};
+
+// Decoded request, copied out of the read buffer so it survives compaction
+struct Request {
+    uint32_t conn;
+    alignas(8) unsigned char bytes[MAX_MESSAGE_SIZE];
+
+    MsgType type() const { return static_cast<MsgType>(bytes[0]); }
+
+    template <typename Msg>
+    Msg as() const {
+        Msg msg;
+        std::memcpy(&msg, bytes, sizeof(Msg));
+        return msg;
+    }
+};
+
+// Who to notify when a resting order trades, and its side for Modify
+struct OrderOwner {
+    uint32_t conn = 0;   // 0: not a gateway order (or already gone)
+    Side     side = Side::Buy;
+};
+
+class Gateway {
+public:
+    Gateway(int listenFd, size_t capacity)
+        : listenFd_(listenFd)
+        , capacity_(capacity)
+        , book_(capacity)
+        , owners_(capacity + 1)
+    {
+        arena_.reserve(1 << 20);
+    }
+
+    int run();
+
+private:
+    void acceptAll();
+    bool readFrom(Connection& c);
+    bool decode(Connection& c);
+    void process(const Request& r);
+    void onNewOrder(uint32_t conn, const NewOrderMsg& m);
+    void onCancel(uint32_t conn, const CancelMsg& m);
+    void onModify(uint32_t conn, const ModifyMsg& m);
+    void execute(uint32_t conn, Side side, OrderType type, Price price, Quantity quantity,
+                 AckMsg& ack);
+    bool owns(uint32_t conn, OrderId id) const;
+    bool validLimit(Price price, Quantity quantity) const;
+
+    template <typename Msg>
+    void emit(uint32_t conn, const Msg& msg);
+
+    bool flush(Connection& c);
+    bool drainBacklog(Connection& c);
+    bool limitBacklog(Connection& c);
+    void updateInterest(Connection& c);
+    void closeConnection(uint32_t id);
+
+    int      listenFd_;
+    int      epollFd_ = -1;
+    size_t   capacity_;
+    OrderBook book_;
+
+    std::unordered_map<uint32_t, Connection> conns_;
+    uint32_t nextConnId_ = 1;
+
+    std::vector<OrderOwner> owners_;   // indexed by OrderId
+    std::vector<Request>    requests_; // current batch
+    std::vector<char>       arena_;    // reply bytes for the current batch
+    std::vector<uint32_t>   dirty_;    // connections with replies this batch
+
+    // Counters reported at shutdown
+    uint64_t batches_ = 0, requestCount_ = 0, reads_ = 0, writes_ = 0, rejects_ = 0;
+    uint64_t pauses_ = 0, overflows_ = 0;
+};
+
+int Gateway::run() {
+    epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd_ < 0) {
+        std::cerr << "epoll_create1: " << std::strerror(errno) << "\n";
+        return 1;
+    }
+    epoll_event ev{};
+    ev.events   = EPOLLIN;
+    ev.data.u64 = LISTENER_ID;
+    epoll_ctl(epollFd_, EPOLL_CTL_ADD, listenFd_, &ev);
+
+    epoll_event events[MAX_EVENTS];
+    while (!stopRequested) {
+        int n = epoll_wait(epollFd_, events, MAX_EVENTS, 200);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "epoll_wait: " << std::strerror(errno) << "\n";
+            return 1;
+        }
+
+        // 1. Ingress: drain sockets into one batch
+        for (int i = 0; i < n; ++i) {
+            auto id = static_cast<uint32_t>(events[i].data.u64);
+            if (id == LISTENER_ID) {
+                acceptAll();
+                continue;
+            }
+            auto it = conns_.find(id);
+            if (it == conns_.end()) continue;
+            Connection& c = it->second;
+
+            bool ok = !(events[i].events & EPOLLERR);
+            if (ok && (events[i].events & EPOLLOUT)) ok = drainBacklog(c);
+            // A hangup is read even while paused: read() returning 0 closes it
+            if (ok && ((events[i].events & EPOLLHUP) ||
+                       (!c.paused && (events[i].events & EPOLLIN)))) {
+                ok = readFrom(c);
+            }
+            if (!ok) closeConnection(id);
+        }
+        if (requests_.empty()) continue;
+
+        // 2. Match the batch
+        ++batches_;
+        requestCount_ += requests_.size();
+        for (const Request& r : requests_) process(r);
+        requests_.clear();
+
+        // 3. Egress: one gathered write per connection
+        for (uint32_t id : dirty_) {
+            auto it = conns_.find(id);
+            if (it == conns_.end()) continue;
+            if (!flush(it->second)) closeConnection(id);
+        }
+        dirty_.clear();
+        arena_.clear();
+    }
+
+    for (auto& [id, c] : conns_) close(c.fd);
+    close(epollFd_);
+
+    std::cout << "requests " << requestCount_ << " (rejected " << rejects_ << "), batches "
+              << batches_ << ", reads " << reads_ << ", writes " << writes_ << "\n"
+              << "backlog pauses " << pauses_ << ", closed over limit " << overflows_ << "\n";
+    if (batches_ > 0) {
+        std::cout << "avg requests/batch " << static_cast<double>(requestCount_) / batches_
+                  << ", avg requests/read "
+                  << static_cast<double>(requestCount_) / std::max<uint64_t>(reads_, 1) << "\n";
+    }
+    return 0;
+}
+
+void Gateway::acceptAll() {
+    for (;;) {
+        int fd = accept4(listenFd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;  // EAGAIN, or a transient error: retried on next readiness
+        setNoDelay(fd);      // no-op on Unix sockets
+
+        uint32_t id = nextConnId_++;
+        Connection& c = conns_[id];
+        c.id = id;
+        c.fd = fd;
+
+        epoll_event ev{};
+        ev.events   = EPOLLIN;
+        ev.data.u64 = id;
+        epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &ev);
+    }
+}
+
+bool Gateway::readFrom(Connection& c) {
+    for (int i = 0; i < MAX_READS_PER_WAKE; ++i) {
+        ssize_t n = ::read(c.fd, c.in.data() + c.inLen, c.in.size() - c.inLen);
+        if (n > 0) {
+            ++reads_;
+            c.inLen += static_cast<size_t>(n);
+            if (!decode(c)) return false;
+            continue;
+        }
+        if (n == 0) return false;  // peer closed
+        if (errno == EINTR) continue;
+        return errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+    return true;  // more may be pending; level-triggered epoll reports it again
+}
+
+// Move complete messages into the batch; false on a malformed stream
+bool Gateway::decode(Connection& c) {
+    size_t pos = 0;
+    while (c.inLen - pos >= sizeof(MsgHeader)) {
+        MsgHeader header;
+        std::memcpy(&header, c.in.data() + pos, sizeof(header));
+        if (header.type != MsgType::NewOrder && header.type != MsgType::Cancel &&
+            header.type != MsgType::Modify) [[unlikely]] {
+            return false;
+        }
+        size_t len = messageLength(header.type);
+        if (header.length != len) [[unlikely]] return false;
+        if (c.inLen - pos < len) break;
+
+        Request& r = requests_.emplace_back();
+        r.conn = c.id;
+        std::memcpy(r.bytes, c.in.data() + pos, len);
+        pos += len;
+    }
+    std::memmove(c.in.data(), c.in.data() + pos, c.inLen - pos);
+    c.inLen -= pos;
+    return true;
+}
+
+void Gateway::process(const Request& r) {
+    switch (r.type()) {
+    case MsgType::NewOrder: onNewOrder(r.conn, r.as<NewOrderMsg>()); break;
+    case MsgType::Cancel:   onCancel(r.conn, r.as<CancelMsg>());     break;
+    case MsgType::Modify:   onModify(r.conn, r.as<ModifyMsg>());     break;
+    default: break;  // filtered by decode()
+    }
+}
+
+bool Gateway::validLimit(Price price, Quantity quantity) const {
+    return quantity > 0 && price >= OrderBook::kMinPrice && price <= OrderBook::kMaxPrice;
+}
+
+bool Gateway::owns(uint32_t conn, OrderId id) const {
+    return id < owners_.size() && owners_[static_cast<size_t>(id)].conn == conn;
+}
+
+void Gateway::onNewOrder(uint32_t conn, const NewOrderMsg& m) {
+    AckMsg ack{};
+    ack.clientTag   = m.clientTag;
+    ack.requestType = MsgType::NewOrder;
+
+    bool valid = static_cast<uint8_t>(m.side) <= 1 &&
+                 (m.orderType == OrderType::Market ? m.quantity > 0
+                  : m.orderType == OrderType::Limit && validLimit(m.price, m.quantity));
+    // Leave one pool slot for the transient market/aggressive order
+    if (!valid || book_.orderCount() + 1 >= capacity_) [[unlikely]] {
+        ack.status = AckStatus::Rejected;
+        ++rejects_;
+        emit(conn, ack);
+        return;
+    }
+
+    ack.status = AckStatus::Accepted;
+    execute(conn, m.side, m.orderType, m.price, m.quantity, ack);
+}
+
+void Gateway::onCancel(uint32_t conn, const CancelMsg& m) {
+    AckMsg ack{};
+    ack.clientTag   = m.clientTag;
+    ack.requestType = MsgType::Cancel;
+    ack.orderId     = m.orderId;
+
+    // Only the entering connection may cancel; filled orders fail in the book
+    if (owns(conn, m.orderId) && book_.cancelOrder(m.orderId)) {
+        owners_[static_cast<size_t>(m.orderId)].conn = 0;
+        ack.status = AckStatus::Cancelled;
+    } else {
+        ack.status = AckStatus::NotFound;
+    }
+    emit(conn, ack);
+}
+
+// Cancel/replace: the replacement is a new order with a new id and may trade
+void Gateway::onModify(uint32_t conn, const ModifyMsg& m) {
+    AckMsg ack{};
+    ack.clientTag   = m.clientTag;
+    ack.requestType = MsgType::Modify;
+    ack.orderId     = m.orderId;
+
+    if (!validLimit(m.price, m.quantity)) [[unlikely]] {
+        ack.status = AckStatus::Rejected;
+        ++rejects_;
+        emit(conn, ack);
+        return;
+    }
+    if (!owns(conn, m.orderId) || !book_.cancelOrder(m.orderId)) {
+        ack.status = AckStatus::NotFound;
+        emit(conn, ack);
+        return;
+    }
+
+    OrderOwner& old = owners_[static_cast<size_t>(m.orderId)];
+    old.conn   = 0;
+    ack.status = AckStatus::Modified;
+    execute(conn, old.side, OrderType::Limit, m.price, m.quantity, ack);
+}
+
+// Run an order through the book, then ack it and report every execution to
+// both sides
+void Gateway::execute(uint32_t conn, Side side, OrderType type, Price price, Quantity quantity,
+                      AckMsg& ack) {
+    OrderResult result = book_.addOrder(side, type, price, quantity);
+
+    ack.orderId           = result.orderId;
+    ack.filledQuantity    = result.filledQuantity;
+    ack.remainingQuantity = result.remainingQuantity;
+    emit(conn, ack);
+
+    if (result.remainingQuantity > 0 && type == OrderType::Limit) {
+        auto idx = static_cast<size_t>(result.orderId);
+        if (idx >= owners_.size()) [[unlikely]] owners_.resize(idx * 2);
+        owners_[idx] = {conn, side};
+    }
+
+    for (const Fill& f : result.fills) {
+        FillMsg fill{};
+        fill.orderId             = f.takerOrderId;
+        fill.counterpartyOrderId = f.makerOrderId;
+        fill.price               = f.price;
+        fill.quantity            = f.quantity;
+        fill.liquidity           = Liquidity::Taker;
+        emit(conn, fill);
+
+        uint32_t maker = owners_[static_cast<size_t>(f.makerOrderId)].conn;
+        if (maker != 0) {
+            fill.orderId             = f.makerOrderId;
+            fill.counterpartyOrderId = f.takerOrderId;
+            fill.liquidity           = Liquidity::Maker;
+            emit(maker, fill);
+        }
+    }
+}
+
+template <typename Msg>
+void Gateway::emit(uint32_t conn, const Msg& msg) {
+    auto it = conns_.find(conn);
+    if (it == conns_.end()) return;  // disconnected earlier in the batch
+    Connection& c = it->second;
+
+    auto offset = static_cast<uint32_t>(arena_.size());
+    const char* p = reinterpret_cast<const char*>(&msg);
+    arena_.insert(arena_.end(), p, p + sizeof(Msg));
+
+    if (c.replies.empty()) {
+        dirty_.push_back(conn);
+    } else if (Span& last = c.replies.back(); last.offset + last.length == offset) {
+        last.length += sizeof(Msg);  // contiguous with the previous reply: one iovec
+        return;
+    }
+    c.replies.push_back({offset, static_cast<uint32_t>(sizeof(Msg))});
+}
+
+bool Gateway::flush(Connection& c) {
+    auto spans = std::move(c.replies);
+    c.replies.clear();
+
+    // Earlier replies still queued: preserve order by queueing behind them
+    if (!c.backlog.empty()) {
+        for (Span s : spans) {
+            c.backlog.insert(c.backlog.end(), arena_.data() + s.offset,
+                             arena_.data() + s.offset + s.length);
+        }
+        return limitBacklog(c);  // EPOLLOUT is armed
+    }
+
+    std::vector<iovec> iov(spans.size());
+    for (size_t i = 0; i < spans.size(); ++i) {
+        iov[i] = {arena_.data() + spans[i].offset, spans[i].length};
+    }
+
+    size_t first = 0;
+    while (first < iov.size()) {
+        int count = static_cast<int>(std::min<size_t>(iov.size() - first, IOV_MAX));
+        ssize_t n = ::writev(c.fd, iov.data() + first, count);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) return false;
+            break;
+        }
+        ++writes_;
+        // Skip fully written iovecs, trim a partially written one
+        auto sent = static_cast<size_t>(n);
+        while (first < iov.size() && sent >= iov[first].iov_len) sent -= iov[first++].iov_len;
+        if (first < iov.size()) {
+            iov[first].iov_base = static_cast<char*>(iov[first].iov_base) + sent;
+            iov[first].iov_len -= sent;
+            if (sent > 0) break;  // short write: socket buffer is full
+        }
+    }
+
+    if (first < iov.size()) {
+        for (size_t i = first; i < iov.size(); ++i) {
+            auto* p = static_cast<char*>(iov[i].iov_base);
+            c.backlog.insert(c.backlog.end(), p, p + iov[i].iov_len);
+        }
+        return limitBacklog(c);
+    }
+    return true;
+}
+
+bool Gateway::drainBacklog(Connection& c) {
+    while (c.backlogSent < c.backlog.size()) {
+        ssize_t n = ::write(c.fd, c.backlog.data() + c.backlogSent, c.unsent());
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) return false;
+            return limitBacklog(c);
+        }
+        ++writes_;
+        c.backlogSent += static_cast<size_t>(n);
+    }
+    c.backlog.clear();
+    c.backlogSent = 0;
+    return limitBacklog(c);
+}
+
+// After the backlog changed: close past the hard limit, pause or resume
+// reading around the watermarks, and compact what has been sent. False if
+// the connection must be closed.
+bool Gateway::limitBacklog(Connection& c) {
+    size_t unsent = c.unsent();
+    if (unsent > BACKLOG_LIMIT_BYTES) [[unlikely]] {
+        ++overflows_;
+        return false;
+    }
+    if (!c.paused && unsent > BACKLOG_PAUSE_BYTES) {
+        c.paused = true;
+        ++pauses_;
+    } else if (c.paused && unsent < BACKLOG_RESUME_BYTES) {
+        c.paused = false;
+    }
+    if (c.backlogSent > 0 && c.backlogSent >= unsent) {
+        c.backlog.erase(c.backlog.begin(), c.backlog.begin() + static_cast<std::ptrdiff_t>(c.backlogSent));
+        c.backlogSent = 0;
+    }
+    updateInterest(c);
+    return true;
+}
+
+void Gateway::updateInterest(Connection& c) {
+    uint32_t interest = (c.paused ? 0 : EPOLLIN) | (c.unsent() > 0 ? EPOLLOUT : 0);
+    if (interest == c.interest) return;
+    c.interest = interest;
+    epoll_event ev{};
+    ev.events   = interest;
+    ev.data.u64 = c.id;
+    epoll_ctl(epollFd_, EPOLL_CTL_MOD, c.fd, &ev);
+}
+
+void Gateway::closeConnection(uint32_t id) {
+    auto it = conns_.find(id);
+    if (it == conns_.end()) return;
+    epoll_ctl(epollFd_, EPOLL_CTL_DEL, it->second.fd, nullptr);
+    close(it->second.fd);
+    conns_.erase(it);
+}
+
+bool parseOption(const char* arg, std::string& endpoint, size_t& capacity) {
+    const char* eq = std::strchr(arg, '=');
+    if (!eq || std::strncmp(arg, "--", 2) != 0) return false;
+    std::string key(arg + 2, eq);
+    const char* value = eq + 1;
+
+    if      (key == "listen")   endpoint = value;
+    else if (key == "capacity") capacity = std::strtoull(value, nullptr, 10);
+    else return false;
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string endpoint = DEFAULT_ENDPOINT;
+    size_t capacity = 1'048'576;
+    for (int i = 1; i < argc; ++i) {
+        if (!parseOption(argv[i], endpoint, capacity)) {
+            std::cerr << "usage: gateway [--listen=host:port | --listen=unix:/path] [--capacity=N]\n";
+            return 1;
+        }
+    }
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+    std::signal(SIGPIPE, SIG_IGN);  // a vanished client surfaces as EPIPE instead
+
+    int fd = listenOn(endpoint);
+    if (fd < 0) return 1;
+    std::cout << "gateway listening on " << endpoint << std::endl;
+
+    Gateway gateway(fd, capacity);
+    int rc = gateway.run();
+    close(fd);
+    if (endpoint.rfind("unix:", 0) == 0) unlink(endpoint.c_str() + 5);
+    return rc;
+}
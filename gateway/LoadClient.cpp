@@ -0,0 +1,219 @@
+// Load generator for the gateway: keeps up to `window` requests in flight on
+// one connection and reports round-trip latency (send -> Ack) per request
+// type, covering the whole ingress path rather than addOrder() alone.
+//
+//   gateway_client [--connect=127.0.0.1:9000 | --connect=unix:/path]
+//       [--requests=N] [--window=W] [--seed=S] [--mid=P]
+//       [--cancel-ratio=R] [--modify-ratio=R] [--warmup=N]
+//
+// The send timestamp travels in clientTag and is echoed in the Ack. Orders
+// rest near `mid` with a few ticks of overlap, so some of them trade.
+
+#include "BenchCommon.h"
+#include "Protocol.h"
+#include "Socket.h"
+
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace orderbook;
+using namespace orderbook::gateway;
+using namespace bench;
+
+namespace {
+
+struct ClientConfig {
+    std::string endpoint    = DEFAULT_ENDPOINT;
+    size_t      requests    = 200'000;
+    size_t      window      = 1;
+    size_t      warmup      = 10'000;   // leading requests excluded from the latency report
+    uint64_t    seed        = 42;
+    Price       mid         = 10'000;
+    double      cancelRatio = 0.35;
+    double      modifyRatio = 0.10;
+};
+
+bool parseOption(const char* arg, ClientConfig& cfg) {
+    const char* eq = std::strchr(arg, '=');
+    if (!eq || std::strncmp(arg, "--", 2) != 0) return false;
+    std::string key(arg + 2, eq);
+    const char* value = eq + 1;
+
+    if      (key == "connect")      cfg.endpoint    = value;
+    else if (key == "requests")     cfg.requests    = std::strtoull(value, nullptr, 10);
+    else if (key == "window")       cfg.window      = std::max<size_t>(1, std::strtoull(value, nullptr, 10));
+    else if (key == "warmup")       cfg.warmup      = std::strtoull(value, nullptr, 10);
+    else if (key == "seed")         cfg.seed        = std::strtoull(value, nullptr, 10);
+    else if (key == "mid")          cfg.mid         = std::strtoll(value, nullptr, 10);
+    else if (key == "cancel-ratio") cfg.cancelRatio = std::atof(value);
+    else if (key == "modify-ratio") cfg.modifyRatio = std::atof(value);
+    else return false;
+    return true;
+}
+
+uint64_t nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        Clock::now().time_since_epoch()).count());
+}
+
+bool writeAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = ::write(fd, data, size);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+template <typename Msg>
+void append(std::vector<char>& out, const Msg& msg) {
+    const char* p = reinterpret_cast<const char*>(&msg);
+    out.insert(out.end(), p, p + sizeof(Msg));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    ClientConfig cfg;
+    for (int i = 1; i < argc; ++i) {
+        if (!parseOption(argv[i], cfg)) {
+            std::cerr << "usage: gateway_client [--connect=host:port | --connect=unix:/path]\n"
+                         "         [--requests=N] [--window=W] [--seed=S] [--mid=P]\n"
+                         "         [--cancel-ratio=R] [--modify-ratio=R] [--warmup=N]\n";
+            return 1;
+        }
+    }
+
+    int fd = connectTo(cfg.endpoint);
+    if (fd < 0) return 1;
+
+    std::mt19937_64 rng(cfg.seed);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    std::uniform_int_distribution<int> offset(-2, 12);   // ticks away from mid; < 0 crosses
+    std::uniform_int_distribution<Quantity> qty(1, 100);
+
+    std::vector<OrderId> resting;        // our orders acked with quantity left
+    std::vector<double>  rtt[3];         // NewOrder, Cancel, Modify
+    std::vector<char>    out;
+    std::vector<char>    in(64 * 1024);
+    size_t inLen = 0;
+
+    for (auto& v : rtt) v.reserve(cfg.requests);
+
+    size_t sent = 0, completed = 0, outstanding = 0;
+    uint64_t fills = 0, notFound = 0, rejected = 0;
+    Clock::time_point start = Clock::now();
+
+    while (completed < cfg.requests) {
+        if (completed == cfg.warmup && outstanding == 0) start = Clock::now();
+
+        // Top the window up; stop at the warm-up boundary so timing starts clean
+        out.clear();
+        while (outstanding < cfg.window && sent < cfg.requests &&
+               !(sent == cfg.warmup && completed < cfg.warmup)) {
+            double r = coin(rng);
+            if (!resting.empty() && r < cfg.cancelRatio + cfg.modifyRatio) {
+                size_t pick = rng() % resting.size();
+                OrderId id = resting[pick];
+                resting[pick] = resting.back();
+                resting.pop_back();
+
+                if (r < cfg.cancelRatio) {
+                    CancelMsg m{};
+                    m.orderId   = id;
+                    m.clientTag = nowNs();
+                    append(out, m);
+                } else {
+                    ModifyMsg m{};
+                    m.orderId   = id;
+                    m.price     = cfg.mid + offset(rng);
+                    m.quantity  = qty(rng);
+                    m.clientTag = nowNs();
+                    append(out, m);
+                }
+            } else {
+                NewOrderMsg m{};
+                m.side      = (rng() & 1) ? Side::Buy : Side::Sell;
+                m.orderType = OrderType::Limit;
+                m.price     = (m.side == Side::Buy) ? cfg.mid - offset(rng) : cfg.mid + offset(rng);
+                m.quantity  = qty(rng);
+                m.clientTag = nowNs();
+                append(out, m);
+            }
+            ++sent;
+            ++outstanding;
+        }
+        if (!out.empty() && !writeAll(fd, out.data(), out.size())) {
+            std::cerr << "write failed: " << std::strerror(errno) << "\n";
+            return 1;
+        }
+
+        ssize_t n = ::read(fd, in.data() + inLen, in.size() - inLen);
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR) continue;
+            std::cerr << "connection closed by gateway\n";
+            return 1;
+        }
+        uint64_t received = nowNs();
+        inLen += static_cast<size_t>(n);
+
+        size_t pos = 0;
+        while (inLen - pos >= sizeof(MsgHeader)) {
+            MsgHeader header;
+            std::memcpy(&header, in.data() + pos, sizeof(header));
+            if (inLen - pos < header.length) break;
+
+            if (header.type == MsgType::Ack) {
+                AckMsg ack;
+                std::memcpy(&ack, in.data() + pos, sizeof(ack));
+                if (completed >= cfg.warmup) {
+                    size_t kind = static_cast<size_t>(ack.requestType) - 1;
+                    rtt[kind].push_back(static_cast<double>(received - ack.clientTag));
+                }
+                if ((ack.status == AckStatus::Accepted || ack.status == AckStatus::Modified) &&
+                    ack.remainingQuantity > 0) {
+                    resting.push_back(ack.orderId);
+                }
+                notFound += (ack.status == AckStatus::NotFound);
+                rejected += (ack.status == AckStatus::Rejected);
+                ++completed;
+                --outstanding;
+            } else if (header.type == MsgType::Fill) {
+                ++fills;
+            } else {
+                std::cerr << "unexpected message type " << static_cast<int>(header.type) << "\n";
+                return 1;
+            }
+            pos += header.length;
+        }
+        std::memmove(in.data(), in.data() + pos, inLen - pos);
+        inLen -= pos;
+    }
+
+    double seconds = elapsedNs(start, Clock::now()) / 1e9;
+    size_t measured = cfg.requests - std::min(cfg.requests, cfg.warmup);
+    close(fd);
+
+    std::cout << "=== Gateway Round Trip (" << cfg.endpoint << ", window " << cfg.window << ") ===\n";
+    std::cout << "Requests: " << measured << " measured (+" << cfg.requests - measured
+              << " warm-up), fills received " << fills << ", not found " << notFound
+              << ", rejected " << rejected << "\n";
+    std::cout << "Throughput: " << std::fixed << std::setprecision(0)
+              << (seconds > 0 ? measured / seconds : 0.0) << " requests/sec\n\n";
+
+    std::vector<double> all;
+    for (auto& v : rtt) all.insert(all.end(), v.begin(), v.end());
+
+    printPercentileHeader("Request");
+    printPercentiles("New Order", rtt[0]);
+    printPercentiles("Cancel", rtt[1]);
+    printPercentiles("Modify", rtt[2]);
+    printPercentiles("All", all);
+    return 0;
+}
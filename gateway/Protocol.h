@@ -0,0 +1,119 @@
+#pragma once
+
+// Fixed-layout binary protocol between order entry clients and the gateway.
+//
+// Every message starts with an 8-byte MsgHeader whose `length` is the size
+// of the whole message; each type has exactly one valid length. Fields are
+// naturally aligned, native (little-endian) byte order, no variable parts.
+//
+//   Client -> gateway: NewOrder, Cancel, Modify
+//   Gateway -> client: Ack (exactly one per request), Fill (one per execution,
+//                      sent to both the taker's and the maker's connection)
+//
+// `clientTag` is opaque to the gateway and echoed in the Ack, so clients can
+// match responses to requests (the load client stores the send timestamp).
+
+#include "Types.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace orderbook::gateway {
+
+enum class MsgType : uint8_t {
+    NewOrder = 1,
+    Cancel   = 2,
+    Modify   = 3,
+    Ack      = 10,
+    Fill     = 11
+};
+
+enum class AckStatus : uint8_t {
+    Accepted  = 0,   // NewOrder processed (possibly fully filled)
+    Cancelled = 1,
+    Modified  = 2,   // cancel/replace done; orderId is the replacement
+    NotFound  = 3,   // Cancel/Modify target not resting
+    Rejected  = 4    // invalid price/quantity or book full
+};
+
+enum class Liquidity : uint8_t {
+    Maker = 0,
+    Taker = 1
+};
+
+struct MsgHeader {
+    MsgType  type;
+    uint8_t  reserved0 = 0;
+    uint16_t length;
+    uint32_t reserved1 = 0;
+};
+
+struct NewOrderMsg {
+    MsgHeader header{MsgType::NewOrder, 0, sizeof(NewOrderMsg)};
+    uint64_t  clientTag;
+    Price     price;       // ignored for market orders
+    Quantity  quantity;
+    Side      side;
+    OrderType orderType;
+    uint16_t  reserved = 0;
+};
+
+struct CancelMsg {
+    MsgHeader header{MsgType::Cancel, 0, sizeof(CancelMsg)};
+    uint64_t  clientTag;
+    OrderId   orderId;
+};
+
+// Cancel/replace: the order loses time priority and gets a new OrderId
+struct ModifyMsg {
+    MsgHeader header{MsgType::Modify, 0, sizeof(ModifyMsg)};
+    uint64_t  clientTag;
+    OrderId   orderId;
+    Price     price;
+    Quantity  quantity;
+    uint32_t  reserved = 0;
+};
+
+struct AckMsg {
+    MsgHeader header{MsgType::Ack, 0, sizeof(AckMsg)};
+    uint64_t  clientTag;
+    OrderId   orderId;
+    Quantity  filledQuantity;
+    Quantity  remainingQuantity;
+    AckStatus status;
+    MsgType   requestType;
+    uint8_t   reserved[6] = {};
+};
+
+struct FillMsg {
+    MsgHeader header{MsgType::Fill, 0, sizeof(FillMsg)};
+    OrderId   orderId;             // the recipient's order
+    OrderId   counterpartyOrderId;
+    Price     price;
+    Quantity  quantity;
+    Liquidity liquidity;
+    uint8_t   reserved[3] = {};
+};
+
+static_assert(sizeof(MsgHeader)   ==  8);
+static_assert(sizeof(NewOrderMsg) == 32);
+static_assert(sizeof(CancelMsg)   == 24);
+static_assert(sizeof(ModifyMsg)   == 40);
+static_assert(sizeof(AckMsg)      == 40);
+static_assert(sizeof(FillMsg)     == 40);
+
+constexpr size_t MAX_MESSAGE_SIZE = 40;
+
+// Expected total length for a message type, 0 if the type is unknown
+constexpr size_t messageLength(MsgType type) {
+    switch (type) {
+    case MsgType::NewOrder: return sizeof(NewOrderMsg);
+    case MsgType::Cancel:   return sizeof(CancelMsg);
+    case MsgType::Modify:   return sizeof(ModifyMsg);
+    case MsgType::Ack:      return sizeof(AckMsg);
+    case MsgType::Fill:     return sizeof(FillMsg);
+    }
+    return 0;
+}
+
+} // namespace orderbook::gateway
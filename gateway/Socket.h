@@ -0,0 +1,115 @@
+#pragma once
+
+// Endpoint parsing and socket setup shared by the gateway and its clients.
+// An endpoint is either "host:port" (IPv4 TCP) or "unix:/path/to/socket".
+// Functions return a file descriptor, or -1 after printing the reason.
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+namespace orderbook::gateway {
+
+constexpr const char* DEFAULT_ENDPOINT = "127.0.0.1:9000";
+
+namespace detail {
+
+// Fills `addr` from the endpoint; returns its length, 0 if malformed
+inline socklen_t resolve(const std::string& endpoint, sockaddr_storage& addr) {
+    std::memset(&addr, 0, sizeof(addr));
+
+    if (endpoint.rfind("unix:", 0) == 0) {
+        auto& un = reinterpret_cast<sockaddr_un&>(addr);
+        std::string path = endpoint.substr(5);
+        if (path.empty() || path.size() >= sizeof(un.sun_path)) return 0;
+        un.sun_family = AF_UNIX;
+        std::memcpy(un.sun_path, path.c_str(), path.size() + 1);
+        return sizeof(sockaddr_un);
+    }
+
+    auto colon = endpoint.rfind(':');
+    if (colon == std::string::npos) return 0;
+    auto& in = reinterpret_cast<sockaddr_in&>(addr);
+    in.sin_family = AF_INET;
+    in.sin_port   = htons(static_cast<uint16_t>(std::strtoul(endpoint.c_str() + colon + 1, nullptr, 10)));
+    if (inet_pton(AF_INET, endpoint.substr(0, colon).c_str(), &in.sin_addr) != 1) return 0;
+    return sizeof(sockaddr_in);
+}
+
+inline int fail(const char* what, const std::string& endpoint) {
+    std::cerr << what << " " << endpoint << ": " << std::strerror(errno) << "\n";
+    return -1;
+}
+
+} // namespace detail
+
+inline bool setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+// Small request/reply messages: send each write immediately (TCP only)
+inline void setNoDelay(int fd) {
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+inline int listenOn(const std::string& endpoint) {
+    sockaddr_storage addr;
+    socklen_t len = detail::resolve(endpoint, addr);
+    if (len == 0) {
+        std::cerr << "bad endpoint: " << endpoint << "\n";
+        return -1;
+    }
+
+    int fd = socket(addr.ss_family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return detail::fail("socket", endpoint);
+
+    if (addr.ss_family == AF_UNIX) {
+        unlink(reinterpret_cast<sockaddr_un&>(addr).sun_path);  // stale socket file
+    } else {
+        int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    }
+
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), len) != 0 || listen(fd, 128) != 0 ||
+        !setNonBlocking(fd)) {
+        detail::fail("listen", endpoint);
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Blocking connected socket
+inline int connectTo(const std::string& endpoint) {
+    sockaddr_storage addr;
+    socklen_t len = detail::resolve(endpoint, addr);
+    if (len == 0) {
+        std::cerr << "bad endpoint: " << endpoint << "\n";
+        return -1;
+    }
+
+    int fd = socket(addr.ss_family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return detail::fail("socket", endpoint);
+
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), len) != 0) {
+        detail::fail("connect", endpoint);
+        close(fd);
+        return -1;
+    }
+    if (addr.ss_family == AF_INET) setNoDelay(fd);
+    return fd;
+}
+
+} // namespace orderbook::gateway
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace orderbook {
+
+// Hot-path instrumentation, selected by BasicOrderBook's `Stats` parameter.
+//
+// NoBookStats: every hook is an empty inline function and the member is
+// [[no_unique_address]], so the uninstrumented book compiles to the same code
+// as before.
+//
+// BookStats: per-operation counters and log2-bucketed histograms. Only the
+// matching thread writes; each counter is a relaxed atomic updated with a
+// plain load + store (no locked RMW), so another thread may call snapshot()
+// at any time. Counters are individually exact; the snapshot as a whole is
+// not a single point in time.
+
+constexpr size_t STATS_HISTOGRAM_BUCKETS = 16;
+
+// Bucket 0 counts zeros; bucket k counts values in [2^(k-1), 2^k);
+// the last bucket absorbs everything larger.
+using HistogramSnapshot = std::array<uint64_t, STATS_HISTOGRAM_BUCKETS>;
+
+struct BookStatsSnapshot {
+    uint64_t adds             = 0;
+    uint64_t marketOrders     = 0;
+    uint64_t cancels          = 0;
+    uint64_t cancelMisses     = 0;   // unknown or already-removed OrderId
+    uint64_t matches          = 0;   // aggressive orders that traded
+    uint64_t fills            = 0;   // maker executions
+    uint64_t bestPriceScans   = 0;   // best level emptied and a new one was found
+    uint64_t indexResizes     = 0;   // OrderId lookup vector growth
+    uint64_t selfTrades       = 0;   // resting orders met by their own owner
+    uint64_t poolInUse        = 0;
+    uint64_t poolHighWater    = 0;
+
+    HistogramSnapshot levelsScanned{};   // ticks walked per best-price recovery
+    HistogramSnapshot fillsPerMatch{};   // maker executions per aggressive order
+    HistogramSnapshot levelDepth{};      // orders at the level after an order rests
+};
+
+struct NoBookStats {
+    static constexpr bool enabled = false;
+
+    void onAdd(bool /*market*/) {}
+    void onPoolAlloc(size_t /*inUse*/) {}
+    void onPoolFree(size_t /*inUse*/) {}
+    void onFill() {}
+    void onMatchEnd() {}
+    void onRest(size_t /*levelDepth*/) {}
+    void onCancel(bool /*found*/) {}
+    void onBestPriceScan(uint64_t /*ticks*/) {}
+    void onIndexResize() {}
+    void onSelfTrade() {}
+
+    BookStatsSnapshot snapshot() const { return {}; }
+};
+
+class BookStats {
+public:
+    static constexpr bool enabled = true;
+
+    void onAdd(bool market) {
+        bump(adds_);
+        if (market) bump(marketOrders_);
+    }
+
+    void onPoolAlloc(size_t inUse) {
+        set(poolInUse_, inUse);
+        if (inUse > poolHighWater_.load(std::memory_order_relaxed)) set(poolHighWater_, inUse);
+    }
+
+    // Absolute, like onPoolAlloc: a book reattached to a populated pool
+    // starts counting from its current occupancy
+    void onPoolFree(size_t inUse) { set(poolInUse_, inUse); }
+
+    void onFill() {
+        bump(fills_);
+        ++pendingFills_;
+    }
+
+    void onMatchEnd() {
+        if (pendingFills_ == 0) return;
+        bump(matches_);
+        record(fillsPerMatch_, pendingFills_);
+        pendingFills_ = 0;
+    }
+
+    void onRest(size_t levelDepth) { record(levelDepth_, levelDepth); }
+
+    void onCancel(bool found) { bump(found ? cancels_ : cancelMisses_); }
+
+    void onBestPriceScan(uint64_t ticks) {
+        bump(bestPriceScans_);
+        record(levelsScanned_, ticks);
+    }
+
+    void onIndexResize() { bump(indexResizes_); }
+
+    void onSelfTrade() { bump(selfTrades_); }
+
+    BookStatsSnapshot snapshot() const {
+        BookStatsSnapshot s;
+        s.adds           = load(adds_);
+        s.marketOrders   = load(marketOrders_);
+        s.cancels        = load(cancels_);
+        s.cancelMisses   = load(cancelMisses_);
+        s.matches        = load(matches_);
+        s.fills          = load(fills_);
+        s.bestPriceScans = load(bestPriceScans_);
+        s.indexResizes   = load(indexResizes_);
+        s.selfTrades     = load(selfTrades_);
+        s.poolInUse      = load(poolInUse_);
+        s.poolHighWater  = load(poolHighWater_);
+        for (size_t b = 0; b < STATS_HISTOGRAM_BUCKETS; ++b) {
+            s.levelsScanned[b] = load(levelsScanned_[b]);
+            s.fillsPerMatch[b] = load(fillsPerMatch_[b]);
+            s.levelDepth[b]    = load(levelDepth_[b]);
+        }
+        return s;
+    }
+
+    static size_t bucketOf(uint64_t value) {
+        size_t b = static_cast<size_t>(std::bit_width(value));
+        return b < STATS_HISTOGRAM_BUCKETS ? b : STATS_HISTOGRAM_BUCKETS - 1;
+    }
+
+private:
+    using Counter   = std::atomic<uint64_t>;
+    using Histogram = std::array<Counter, STATS_HISTOGRAM_BUCKETS>;
+
+    static uint64_t load(const Counter& c) { return c.load(std::memory_order_relaxed); }
+    static void set(Counter& c, uint64_t v) { c.store(v, std::memory_order_relaxed); }
+    static void bump(Counter& c) { set(c, load(c) + 1); }
+    static void record(Histogram& h, uint64_t value) { bump(h[bucketOf(value)]); }
+
+    Counter adds_{0};
+    Counter marketOrders_{0};
+    Counter cancels_{0};
+    Counter cancelMisses_{0};
+    Counter matches_{0};
+    Counter fills_{0};
+    Counter bestPriceScans_{0};
+    Counter indexResizes_{0};
+    Counter selfTrades_{0};
+    Counter poolInUse_{0};
+    Counter poolHighWater_{0};
+
+    Histogram levelsScanned_{};
+    Histogram fillsPerMatch_{};
+    Histogram levelDepth_{};
+
+    uint64_t pendingFills_ = 0;   // writer-only scratch for fillsPerMatch
+};
+
+} // namespace orderbook
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Types.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace orderbook {
+
+// Compact binary order message journal, replayed by the benchmarks.
+//
+// Layout: MessageFileHeader followed by `count` fixed 32-byte Message
+// records, little-endian, no padding surprises (checked below). Each symbol
+// is an independent book; OrderIds are assigned per symbol in add order
+// starting at 1, so a Cancel refers to its target by that sequence number.
+
+enum class MessageType : uint8_t {
+    AddLimit  = 0,
+    AddMarket = 1,
+    Cancel    = 2
+};
+
+constexpr size_t NUM_MESSAGE_TYPES = 3;
+
+struct Message {
+    uint64_t    ref;        // Cancel: target OrderId; otherwise 0
+    Price       price;      // AddLimit only
+    Quantity    quantity;   // AddLimit / AddMarket
+    uint32_t    symbol;
+    MessageType type;
+    Side        side;
+    uint8_t     reserved[6] = {};
+};
+
+static_assert(sizeof(Message) == 32, "Message is a fixed 32-byte wire record");
+
+struct MessageFileHeader {
+    char     magic[4] = {'O', 'B', 'M', 'F'};
+    uint32_t version  = 1;
+    uint64_t count    = 0;
+};
+
+static_assert(sizeof(MessageFileHeader) == 16, "MessageFileHeader is 16 bytes");
+
+// True if a book over [minPrice, maxPrice] can apply `m`: a known type and
+// side, and for AddLimit a price inside the range. Replayers check records
+// before applying them, since a journal is external input.
+inline bool isValidMessage(const Message& m, Price minPrice, Price maxPrice) {
+    if (m.side != Side::Buy && m.side != Side::Sell) return false;
+    switch (m.type) {
+    case MessageType::AddLimit:  return m.price >= minPrice && m.price <= maxPrice;
+    case MessageType::AddMarket: return true;
+    case MessageType::Cancel:    return true;
+    }
+    return false;
+}
+
+inline bool writeMessageFile(const std::string& path, const std::vector<Message>& messages) {
+    std::FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) return false;
+
+    MessageFileHeader header;
+    header.count = messages.size();
+    bool ok = std::fwrite(&header, sizeof(header), 1, f) == 1 &&
+              std::fwrite(messages.data(), sizeof(Message), messages.size(), f) == messages.size();
+    return std::fclose(f) == 0 && ok;
+}
+
+inline bool readMessageFile(const std::string& path, std::vector<Message>& messages) {
+    std::FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) return false;
+
+    MessageFileHeader header;
+    bool ok = std::fread(&header, sizeof(header), 1, f) == 1 &&
+              std::memcmp(header.magic, MessageFileHeader{}.magic, sizeof(header.magic)) == 0 &&
+              header.version == MessageFileHeader{}.version;
+    // Bound the count by the file length before allocating for it
+    long end = -1;
+    ok = ok && std::fseek(f, 0, SEEK_END) == 0 && (end = std::ftell(f)) >= 0 &&
+         std::fseek(f, static_cast<long>(sizeof(header)), SEEK_SET) == 0 &&
+         header.count <= (static_cast<uint64_t>(end) - sizeof(header)) / sizeof(Message);
+    if (ok) {
+        messages.resize(static_cast<size_t>(header.count));
+        ok = std::fread(messages.data(), sizeof(Message), messages.size(), f) == messages.size();
+    }
+    std::fclose(f);
+    return ok;
+}
+
+} // namespace orderbook
@@ -2,17 +2,30 @@
 
 #include "Types.h"
 
+#include <type_traits>
+
 namespace orderbook {
 
+// Position of an Order in its OrderPool. Links are slots rather than
+// pointers so the whole book is position-independent and can live in shared
+// memory (see SharedBook.h). Slot 0 is never allocated and means "none", so
+// zero-filled memory is a valid empty list / index.
+using OrderSlot = uint32_t;
+constexpr OrderSlot NO_ORDER = 0;
+
 struct Order {
     OrderId   id;
     Side      side;
     OrderType type;
+    SelfTradePrevention stp;     // applied when this order is the aggressor
+    OwnerId   owner;
     Price     price;
     Quantity  quantity;
     Timestamp timestamp;
-    Order*    prev = nullptr;
-    Order*    next = nullptr;
+    OrderSlot prev = NO_ORDER;
+    OrderSlot next = NO_ORDER;
 };
 
+static_assert(std::is_trivially_copyable_v<Order>, "Order must be safe to place in shared memory");
+
 } // namespace orderbook
@@ -1,87 +1,160 @@
 #include "OrderBook.h"
+#include "SharedBook.h"
 
 #include <algorithm>
+#include <cstdio>
+#include <cstdlib>
 
 namespace orderbook {
 
-OrderBook::OrderBook(size_t poolCapacity)
-    : bidLevels_(NUM_PRICE_LEVELS)
-    , askLevels_(NUM_PRICE_LEVELS)
-    , orders_(poolCapacity + 1, nullptr)
+namespace {
+
+// A hosted book writes through its segment from the first operation, so an
+// unmapped or read-only segment is a caller bug. Checked in every build
+// type: the alternative is a fault on the first write.
+SharedBookSegment& requireWritable(SharedBookSegment& segment) {
+    if (!segment.writable()) {
+        std::fprintf(stderr, "OrderBook: shared segment '%s' is %s\n", segment.name().c_str(),
+                     segment.valid() ? "mapped read-only" : "not mapped");
+        std::abort();
+    }
+    return segment;
+}
+
+} // namespace
+
+template <typename Levels, typename Stats>
+BasicOrderBook<Levels, Stats>::BasicOrderBook(size_t poolCapacity)
+    : ownedIndex_(poolCapacity + 1, NO_ORDER)
+    , index_(ownedIndex_.data())
+    , indexSize_(ownedIndex_.size())
     , pool_(poolCapacity)
 {
 }
 
-OrderResult OrderBook::addOrder(Side side, OrderType type, Price price, Quantity quantity) {
+template <typename Levels, typename Stats>
+BasicOrderBook<Levels, Stats>::BasicOrderBook(SharedBookSegment&& segment)
+    requires std::is_same_v<Levels, DenseLevelIndex>
+    // Braces: the check is sequenced before the other accessors read the header
+    : bids_{requireWritable(segment).bidLevels(), segment.bidQty()}
+    , asks_(segment.askLevels(), segment.askQty())
+    , bestBid_(segment.header().bestBid)
+    , bestAsk_(segment.header().bestAsk)
+    , index_(segment.index())
+    , indexSize_(segment.header().indexEntries.load(std::memory_order_relaxed))
+    , pool_(segment.slots(), segment.freeList(), segment.header().freeTop,
+            segment.header().poolCapacity)
+    , numBidLevels_(segment.header().numBidLevels)
+    , numAskLevels_(segment.header().numAskLevels)
+    , numOrders_(segment.header().numOrders)
+    , nextId_(segment.header().nextId)
+    , segment_(std::make_unique<SharedBookSegment>(std::move(segment)))
+{
+    stats_.onPoolAlloc(pool_.inUse());   // orders already resting in the segment
+}
+
+template <typename Levels, typename Stats>
+BasicOrderBook<Levels, Stats>::~BasicOrderBook() = default;
+
+template <typename Levels, typename Stats>
+OrderResult BasicOrderBook<Levels, Stats>::addOrder(Side side, OrderType type, Price price, Quantity quantity,
+                                                    OwnerId owner, SelfTradePrevention stp) {
+    // The OrderId must have an index entry before anything changes; a
+    // shared segment's index can fail to grow, which rejects the order
+    if (nextId_ >= static_cast<OrderId>(indexSize_)) [[unlikely]] {
+        if (!growIndex(static_cast<size_t>(nextId_))) {
+            return OrderResult{};
+        }
+    }
+
+    beginUpdate();
     Order* order   = pool_.alloc();
+    stats_.onAdd(type == OrderType::Market);
+    stats_.onPoolAlloc(pool_.inUse());
     order->id      = nextId_++;
     order->side    = side;
     order->type    = type;
+    order->stp     = stp;
+    order->owner   = owner;
     order->price   = price;
     order->quantity = quantity;
     order->timestamp = std::chrono::steady_clock::now();
-    order->prev    = nullptr;
-    order->next    = nullptr;
+    order->prev    = NO_ORDER;
+    order->next    = NO_ORDER;
 
     OrderResult result{};
     result.orderId           = order->id;
     result.filledQuantity    = 0;
     result.remainingQuantity = quantity;
 
-    matchOrder(order, result);
+    if (fillReporting_ == FillReporting::PerOrder) [[likely]] {
+        matchOrder<FillReporting::PerOrder>(order, result);
+    } else {
+        matchOrder<FillReporting::Conflated>(order, result);
+    }
+    stats_.onMatchEnd();
 
     result.remainingQuantity = order->quantity;
 
     // Rest remaining quantity on book (limit orders only)
     if (order->quantity > 0 && type == OrderType::Limit) [[likely]] {
-        size_t idx = static_cast<size_t>(price - MIN_PRICE);
+        size_t idx = levelOf(price);
+        Levels& levels = (side == Side::Buy) ? bids_ : asks_;
+
+        levels.materialize(idx);
+        bool wasEmpty = levels.level(idx).empty();
+        OrderSlot slot = pool_.slotOf(order);
+        levels.level(idx).pushBack(pool_.slots(), slot);
+        levels.quantity(idx) += order->quantity;
+        if (wasEmpty) levels.levelAdded(idx);
+        stats_.onRest(levels.level(idx).count);
 
         if (side == Side::Buy) {
-            bool wasEmpty = bidLevels_[idx].empty();
-            bidLevels_[idx].pushBack(order);
             if (wasEmpty) ++numBidLevels_;
             if (price > bestBid_) bestBid_ = price;
         } else {
-            bool wasEmpty = askLevels_[idx].empty();
-            askLevels_[idx].pushBack(order);
             if (wasEmpty) ++numAskLevels_;
             if (price < bestAsk_) bestAsk_ = price;
         }
 
-        // Grow lookup vector if needed
-        if (order->id >= static_cast<OrderId>(orders_.size())) [[unlikely]] {
-            orders_.resize(static_cast<size_t>(order->id) * 2, nullptr);
-        }
-        orders_[static_cast<size_t>(order->id)] = order;
+        index_[static_cast<size_t>(order->id)] = slot;
         ++numOrders_;
     } else {
         // Fully filled or market order — return to pool
         pool_.dealloc(order);
+        stats_.onPoolFree(pool_.inUse());
     }
 
+    endUpdate();
     return result;
 }
 
-bool OrderBook::cancelOrder(OrderId id) {
+template <typename Levels, typename Stats>
+bool BasicOrderBook<Levels, Stats>::cancelOrder(OrderId id) {
     auto idx = static_cast<size_t>(id);
-    if (idx >= orders_.size() || orders_[idx] == nullptr) [[unlikely]] {
+    if (idx >= indexSize_ || index_[idx] == NO_ORDER) [[unlikely]] {
+        stats_.onCancel(false);
         return false;
     }
-
-    Order* order = orders_[idx];
-    size_t levelIdx = static_cast<size_t>(order->price - MIN_PRICE);
-
-    if (order->side == Side::Buy) {
-        bidLevels_[levelIdx].remove(order);
-        if (bidLevels_[levelIdx].empty()) {
+    stats_.onCancel(true);
+    beginUpdate();
+
+    OrderSlot slot = index_[idx];
+    Order* order = &pool_.slots()[slot];
+    size_t levelIdx = levelOf(order->price);
+    Levels& levels = (order->side == Side::Buy) ? bids_ : asks_;
+
+    auto& level = levels.level(levelIdx);
+    level.remove(pool_.slots(), slot);
+    levels.quantity(levelIdx) -= order->quantity;
+    if (level.empty()) {
+        levels.levelRemoved(levelIdx);
+        if (order->side == Side::Buy) {
             --numBidLevels_;
             if (order->price == bestBid_) {
                 updateBestBidDown();
             }
-        }
-    } else {
-        askLevels_[levelIdx].remove(order);
-        if (askLevels_[levelIdx].empty()) {
+        } else {
             --numAskLevels_;
             if (order->price == bestAsk_) {
                 updateBestAskUp();
@@ -89,150 +162,355 @@ bool OrderBook::cancelOrder(OrderId id) {
         }
     }
 
-    orders_[idx] = nullptr;
+    index_[idx] = NO_ORDER;
     --numOrders_;
     pool_.dealloc(order);
+    stats_.onPoolFree(pool_.inUse());
+    endUpdate();
     return true;
 }
 
-std::vector<PriceLevel> OrderBook::getBids(size_t depth) const {
+template <typename Levels, typename Stats>
+std::vector<PriceLevel> BasicOrderBook<Levels, Stats>::getBids(size_t depth) const {
     std::vector<PriceLevel> levels;
     levels.reserve(depth);
 
-    if (bestBid_ < MIN_PRICE) return levels;
+    if (bestBid_ < kMinPrice) return levels;
 
-    Price p = bestBid_;
-    while (p >= MIN_PRICE && levels.size() < depth) {
-        const auto& level = bidLevels_[static_cast<size_t>(p - MIN_PRICE)];
+    // Stop at the last level rather than scanning the empty rest of the range
+    depth = std::min(depth, numBidLevels_);
+    for (size_t i = levelOf(bestBid_); i != Levels::npos && levels.size() < depth;) {
+        const PriceLevelList& level = bids_.level(i);
         if (!level.empty()) {
-            Quantity total = 0;
-            for (const Order* o = level.head; o != nullptr; o = o->next) {
-                total += o->quantity;
-            }
-            levels.push_back({p, total, level.count});
+            levels.push_back({kMinPrice + static_cast<Price>(i), bids_.quantityAt(i), level.count});
         }
-        --p;
+        if (levels.size() < depth) i = bids_.scanDown(i - 1);
     }
 
     return levels;
 }
 
-std::vector<PriceLevel> OrderBook::getAsks(size_t depth) const {
+template <typename Levels, typename Stats>
+std::vector<PriceLevel> BasicOrderBook<Levels, Stats>::getAsks(size_t depth) const {
     std::vector<PriceLevel> levels;
     levels.reserve(depth);
 
-    if (bestAsk_ > MAX_PRICE) return levels;
+    if (bestAsk_ > kMaxPrice) return levels;
 
-    Price p = bestAsk_;
-    while (p <= MAX_PRICE && levels.size() < depth) {
-        const auto& level = askLevels_[static_cast<size_t>(p - MIN_PRICE)];
+    depth = std::min(depth, numAskLevels_);
+    for (size_t i = levelOf(bestAsk_); i != Levels::npos && levels.size() < depth;) {
+        const PriceLevelList& level = asks_.level(i);
         if (!level.empty()) {
-            Quantity total = 0;
-            for (const Order* o = level.head; o != nullptr; o = o->next) {
-                total += o->quantity;
-            }
-            levels.push_back({p, total, level.count});
+            levels.push_back({kMinPrice + static_cast<Price>(i), asks_.quantityAt(i), level.count});
         }
-        ++p;
+        if (levels.size() < depth) i = asks_.scanUp(i + 1);
     }
 
     return levels;
 }
 
-void OrderBook::matchOrder(Order* order, OrderResult& result) {
-    result.fills.reserve(16);  // #1: pre-allocate fills vector
+template <typename Levels, typename Stats>
+void BasicOrderBook<Levels, Stats>::setFillReporting(FillReporting mode, MakerExecutionHandler handler,
+                                              void* context) {
+    fillReporting_ = mode;
+    makerHandler_  = handler;
+    makerContext_  = context;
+}
+
+template <typename Levels, typename Stats>
+void BasicOrderBook<Levels, Stats>::setSelfTradeHandler(SelfTradeHandler handler, void* context) {
+    selfTradeHandler_ = handler;
+    selfTradeContext_ = context;
+}
+
+template <typename Levels, typename Stats>
+FillEstimate BasicOrderBook<Levels, Stats>::estimateBuy(Quantity quantity) const {
+    FillEstimate est{0, 0, bestAsk_, 0};
+    Quantity remaining = quantity;
+
+    // Bounded by the level count so a sweep past the last level never scans
+    // the empty remainder of the price range
+    for (size_t i = levelOf(bestAsk_);
+         i != Levels::npos && remaining > 0 && est.levelsSwept < numAskLevels_;) {
+        if (!asks_.level(i).empty()) {
+            Price    p    = kMinPrice + static_cast<Price>(i);
+            Quantity take = static_cast<Quantity>(std::min<LevelQuantity>(remaining, asks_.quantityAt(i)));
+            est.notional += static_cast<int64_t>(take) * p;
+            est.worstPrice = p;
+            ++est.levelsSwept;
+            remaining -= take;
+        }
+        if (remaining > 0 && est.levelsSwept < numAskLevels_) i = asks_.scanUp(i + 1);
+    }
+
+    est.filledQuantity = quantity - remaining;
+    return est;
+}
+
+template <typename Levels, typename Stats>
+FillEstimate BasicOrderBook<Levels, Stats>::estimateSell(Quantity quantity) const {
+    FillEstimate est{0, 0, bestBid_, 0};
+    Quantity remaining = quantity;
+
+    for (size_t i = levelOf(bestBid_);
+         i != Levels::npos && remaining > 0 && est.levelsSwept < numBidLevels_;) {
+        if (!bids_.level(i).empty()) {
+            Price    p    = kMinPrice + static_cast<Price>(i);
+            Quantity take = static_cast<Quantity>(std::min<LevelQuantity>(remaining, bids_.quantityAt(i)));
+            est.notional += static_cast<int64_t>(take) * p;
+            est.worstPrice = p;
+            ++est.levelsSwept;
+            remaining -= take;
+        }
+        if (remaining > 0 && est.levelsSwept < numBidLevels_) i = bids_.scanDown(i - 1);
+    }
+
+    est.filledQuantity = quantity - remaining;
+    return est;
+}
+
+template <typename Levels, typename Stats>
+uint64_t BasicOrderBook<Levels, Stats>::bidQuantityWithin(Price ticks) const {
+    if (bestBid_ < kMinPrice || ticks < 0) return 0;
+    // Clamp before subtracting: a huge `ticks` must not overflow
+    Price lo = bestBid_ - std::min(ticks, bestBid_ - kMinPrice);
+    return bids_.sumQuantity(levelOf(lo), levelOf(bestBid_));
+}
+
+template <typename Levels, typename Stats>
+uint64_t BasicOrderBook<Levels, Stats>::askQuantityWithin(Price ticks) const {
+    if (bestAsk_ > kMaxPrice || ticks < 0) return 0;
+    Price hi = bestAsk_ + std::min(ticks, kMaxPrice - bestAsk_);
+    return asks_.sumQuantity(levelOf(bestAsk_), levelOf(hi));
+}
+
+template <typename Levels, typename Stats>
+template <FillReporting Mode>
+void BasicOrderBook<Levels, Stats>::matchOrder(Order* order, OrderResult& result) {
+    if constexpr (Mode == FillReporting::PerOrder) {
+        result.fills.reserve(16);  // #1: pre-allocate fills vector
+    } else {
+        result.levelFills.reserve(16);
+    }
+    TradeTally tally;
+
+    // Orders without an owner never self-trade and take the unchecked loop
+    const bool selfTradeCheck = order->owner != NO_OWNER;
 
     if (order->side == Side::Buy) {
         // Match against asks (lowest price first)
-        while (order->quantity > 0 && bestAsk_ <= MAX_PRICE) {
+        while (order->quantity > 0 && bestAsk_ <= kMaxPrice) {
             if (order->type == OrderType::Limit && order->price < bestAsk_) [[unlikely]] {
                 break;
             }
 
-            auto& level = askLevels_[static_cast<size_t>(bestAsk_ - MIN_PRICE)];
-            while (order->quantity > 0 && !level.empty()) {
-                Order* resting = level.front();
-                Quantity fillQty = std::min(order->quantity, resting->quantity);
-
-                Fill fill{};
-                fill.makerOrderId = resting->id;
-                fill.takerOrderId = order->id;
-                fill.price        = resting->price;
-                fill.quantity     = fillQty;
-                result.fills.push_back(fill);
-
-                order->quantity   -= fillQty;
-                resting->quantity -= fillQty;
-                result.filledQuantity += fillQty;
-
-                if (resting->quantity == 0) [[unlikely]] {
-                    level.remove(resting);
-                    orders_[static_cast<size_t>(resting->id)] = nullptr;
-                    --numOrders_;
-                    pool_.dealloc(resting);
-                }
-            }
+            size_t idx = levelOf(bestAsk_);
+            auto& level = asks_.level(idx);
+            if (selfTradeCheck) matchLevel<Mode, true>(order, level, asks_.quantity(idx), result, tally);
+            else                matchLevel<Mode, false>(order, level, asks_.quantity(idx), result, tally);
 
             if (level.empty()) [[unlikely]] {
                 --numAskLevels_;
+                asks_.levelRemoved(idx);
                 updateBestAskUp();
             }
         }
     } else {
         // Match against bids (highest price first)
-        while (order->quantity > 0 && bestBid_ >= MIN_PRICE) {
+        while (order->quantity > 0 && bestBid_ >= kMinPrice) {
             if (order->type == OrderType::Limit && order->price > bestBid_) [[unlikely]] {
                 break;
             }
 
-            auto& level = bidLevels_[static_cast<size_t>(bestBid_ - MIN_PRICE)];
-            while (order->quantity > 0 && !level.empty()) {
-                Order* resting = level.front();
-                Quantity fillQty = std::min(order->quantity, resting->quantity);
-
-                Fill fill{};
-                fill.makerOrderId = resting->id;
-                fill.takerOrderId = order->id;
-                fill.price        = resting->price;
-                fill.quantity     = fillQty;
-                result.fills.push_back(fill);
-
-                order->quantity   -= fillQty;
-                resting->quantity -= fillQty;
-                result.filledQuantity += fillQty;
-
-                if (resting->quantity == 0) [[unlikely]] {
-                    level.remove(resting);
-                    orders_[static_cast<size_t>(resting->id)] = nullptr;
-                    --numOrders_;
-                    pool_.dealloc(resting);
-                }
-            }
+            size_t idx = levelOf(bestBid_);
+            auto& level = bids_.level(idx);
+            if (selfTradeCheck) matchLevel<Mode, true>(order, level, bids_.quantity(idx), result, tally);
+            else                matchLevel<Mode, false>(order, level, bids_.quantity(idx), result, tally);
 
             if (level.empty()) [[unlikely]] {
                 --numBidLevels_;
+                bids_.levelRemoved(idx);
                 updateBestBidDown();
             }
         }
     }
+
+    tradeStats_.onMatchEnd(tally, order->timestamp);
 }
 
-void OrderBook::updateBestBidDown() {
-    --bestBid_;
-    while (bestBid_ >= MIN_PRICE &&
-           bidLevels_[static_cast<size_t>(bestBid_ - MIN_PRICE)].empty()) {
-        --bestBid_;
+// Fill `order` against one price level in FIFO order until either side is
+// exhausted. With SelfTradeCheck, each resting order is checked for the
+// aggressor's owner as it is reached.
+template <typename Levels, typename Stats>
+template <FillReporting Mode, bool SelfTradeCheck>
+void BasicOrderBook<Levels, Stats>::matchLevel(Order* order, PriceLevelList& level, LevelQuantity& levelQty,
+                                        OrderResult& result, TradeTally& tally) {
+    Order*   slots       = pool_.slots();
+    Price    levelPrice  = slots[level.front()].price;
+    Quantity levelFilled = 0;
+    uint32_t makerCount  = 0;
+
+    while (order->quantity > 0 && !level.empty()) {
+        OrderSlot restingSlot = level.front();
+        Order*    resting     = &slots[restingSlot];
+
+        // One compare, on a line the fill touches anyway
+        if constexpr (SelfTradeCheck) {
+            if (resting->owner == order->owner) [[unlikely]] {
+                preventSelfTrade(order, level, levelQty, restingSlot, result);
+                continue;
+            }
+        }
+
+        Quantity fillQty = std::min(order->quantity, resting->quantity);
+
+        order->quantity   -= fillQty;
+        resting->quantity -= fillQty;
+        levelQty          -= fillQty;
+        result.filledQuantity += fillQty;
+        levelFilled += fillQty;
+        ++makerCount;
+        stats_.onFill();
+
+        if constexpr (Mode == FillReporting::PerOrder) {
+            Fill fill{};
+            fill.makerOrderId = resting->id;
+            fill.takerOrderId = order->id;
+            fill.price        = resting->price;
+            fill.quantity     = fillQty;
+            result.fills.push_back(fill);
+        } else {
+            if (makerHandler_) {
+                makerHandler_(makerContext_, resting->id, fillQty, resting->quantity);
+            }
+        }
+
+        if (resting->quantity == 0) [[unlikely]] {
+            releaseResting(level, restingSlot);
+        }
+    }
+
+    // All fills at a level share its price: one trade-stats update per level
+    // (none if self-trade prevention removed everything it met)
+    if constexpr (SelfTradeCheck) {
+        if (makerCount == 0) [[unlikely]] return;
+    }
+    tally.add(levelPrice, levelFilled, makerCount);
+    if constexpr (Mode == FillReporting::Conflated) {
+        result.levelFills.push_back({levelPrice, levelFilled, makerCount});
     }
-    // bestBid_ < MIN_PRICE means no bids exist (sentinel)
 }
 
-void OrderBook::updateBestAskUp() {
-    ++bestAsk_;
-    while (bestAsk_ <= MAX_PRICE &&
-           askLevels_[static_cast<size_t>(bestAsk_ - MIN_PRICE)].empty()) {
-        ++bestAsk_;
+// `order` met its own resting order: apply the aggressor's STP mode instead
+// of trading
+template <typename Levels, typename Stats>
+void BasicOrderBook<Levels, Stats>::preventSelfTrade(Order* order, PriceLevelList& level,
+                                                     LevelQuantity& levelQty, OrderSlot restingSlot,
+                                                     OrderResult& result) {
+    Order*   resting      = &pool_.slots()[restingSlot];
+    Quantity restingCut   = 0;
+    Quantity aggressorCut = 0;
+    switch (order->stp) {
+        case SelfTradePrevention::CancelResting:
+            restingCut = resting->quantity;
+            break;
+        case SelfTradePrevention::CancelAggressor:
+            aggressorCut = order->quantity;
+            break;
+        case SelfTradePrevention::CancelBoth:
+            restingCut   = resting->quantity;
+            aggressorCut = order->quantity;
+            break;
+        case SelfTradePrevention::Decrement:
+            restingCut = aggressorCut = std::min(order->quantity, resting->quantity);
+            break;
     }
-    // bestAsk_ > MAX_PRICE means no asks exist (sentinel)
+    stats_.onSelfTrade();
+
+    order->quantity          -= aggressorCut;
+    result.selfTradeQuantity += aggressorCut;
+    if (restingCut == 0) return;
+
+    resting->quantity -= restingCut;
+    levelQty          -= restingCut;
+    if (selfTradeHandler_) {
+        selfTradeHandler_(selfTradeContext_, resting->id, restingCut, resting->quantity);
+    }
+    if (resting->quantity == 0) releaseResting(level, restingSlot);
+}
+
+// Unlink a resting order that has no quantity left and return it to the pool
+template <typename Levels, typename Stats>
+void BasicOrderBook<Levels, Stats>::releaseResting(PriceLevelList& level, OrderSlot slot) {
+    Order* resting = &pool_.slots()[slot];
+    level.remove(pool_.slots(), slot);
+    index_[static_cast<size_t>(resting->id)] = NO_ORDER;
+    --numOrders_;
+    pool_.dealloc(resting);
+    stats_.onPoolFree(pool_.inUse());
 }
 
+template <typename Levels, typename Stats>
+void BasicOrderBook<Levels, Stats>::updateBestBidDown() {
+    // With no bid levels left there is nothing to find; skip the scan
+    size_t i = (numBidLevels_ == 0) ? Levels::npos : bids_.scanDown(levelOf(bestBid_) - 1);
+    // bestBid_ < kMinPrice means no bids exist (sentinel)
+    Price next = (i == Levels::npos) ? kMinPrice - 1 : kMinPrice + static_cast<Price>(i);
+    // Distance to the sentinel is not a scan
+    if (i != Levels::npos) stats_.onBestPriceScan(static_cast<uint64_t>(bestBid_ - next));
+    bestBid_ = next;
+}
+
+template <typename Levels, typename Stats>
+void BasicOrderBook<Levels, Stats>::updateBestAskUp() {
+    size_t i = (numAskLevels_ == 0) ? Levels::npos : asks_.scanUp(levelOf(bestAsk_) + 1);
+    // bestAsk_ > kMaxPrice means no asks exist (sentinel)
+    Price next = (i == Levels::npos) ? kMaxPrice + 1 : kMinPrice + static_cast<Price>(i);
+    if (i != Levels::npos) stats_.onBestPriceScan(static_cast<uint64_t>(next - bestAsk_));
+    bestAsk_ = next;
+}
+
+// Grow the OrderId index (doubling) so it covers `id`
+template <typename Levels, typename Stats>
+bool BasicOrderBook<Levels, Stats>::growIndex(size_t id) {
+    size_t entries = id * 2;
+    if (segment_) {
+        // The segment reserves the index's address range: grows in place,
+        // up to SHARED_BOOK_MAX_INDEX and as far as the segment can be extended
+        entries = std::min<size_t>(entries, SHARED_BOOK_MAX_INDEX);
+        if (id >= entries || !segment_->growIndex(entries)) return false;
+    } else {
+        ownedIndex_.resize(entries, NO_ORDER);
+        index_ = ownedIndex_.data();
+    }
+    indexSize_ = entries;
+    stats_.onIndexResize();
+    return true;
+}
+
+template <typename Levels, typename Stats>
+void BasicOrderBook<Levels, Stats>::beginUpdate() {
+    if (segment_) [[unlikely]] segment_->beginWrite();
+}
+
+// Publishes the book scalars to the segment header and closes the operation
+template <typename Levels, typename Stats>
+void BasicOrderBook<Levels, Stats>::endUpdate() {
+    if (!segment_) [[likely]] return;
+    SharedBookHeader& h = segment_->header();
+    h.freeTop      = pool_.freeTop();
+    h.bestBid      = bestBid_;
+    h.bestAsk      = bestAsk_;
+    h.numBidLevels = numBidLevels_;
+    h.numAskLevels = numAskLevels_;
+    h.numOrders    = numOrders_;
+    h.nextId       = nextId_;
+    segment_->endWrite();
+}
+
+template class BasicOrderBook<DenseLevelIndex>;
+template class BasicOrderBook<PagedLevelIndex<>>;
+template class BasicOrderBook<DenseLevelIndex, BookStats>;
+template class BasicOrderBook<PagedLevelIndex<>, BookStats>;
+
 } // namespace orderbook
@@ -1,115 +1,211 @@
 #pragma once
 
-#include "Order.h"
+#include "BookStats.h"
+#include "PriceLevelIndex.h"
+#include "TradeStats.h"
 
 #include <vector>
 #include <cassert>
+#include <memory>
+#include <type_traits>
 
 namespace orderbook {
 
-// Price range for flat array indexing
-constexpr Price  MIN_PRICE = 0;
-constexpr Price  MAX_PRICE = 20000;
-constexpr size_t NUM_PRICE_LEVELS = static_cast<size_t>(MAX_PRICE - MIN_PRICE) + 1;
-
-// Intrusive doubly-linked list for orders at a single price level
-struct PriceLevelList {
-    Order* head = nullptr;
-    Order* tail = nullptr;
-    size_t count = 0;
-
-    bool empty() const { return head == nullptr; }
-
-    void pushBack(Order* order) {
-        order->prev = tail;
-        order->next = nullptr;
-        if (tail) tail->next = order;
-        else head = order;
-        tail = order;
-        ++count;
-    }
-
-    void remove(Order* order) {
-        if (order->prev) order->prev->next = order->next;
-        else head = order->next;
-        if (order->next) order->next->prev = order->prev;
-        else tail = order->prev;
-        order->prev = nullptr;
-        order->next = nullptr;
-        --count;
-    }
+class SharedBookSegment;
 
-    Order* front() const { return head; }
-};
-
-// Pre-allocated object pool for Order objects
+// Pre-allocated object pool for Order objects. Orders are addressed by slot;
+// slot 0 is the NO_ORDER sentinel and never handed out. The slot array and
+// free list are owned, or placed by the caller (shared-memory books), in
+// which case the caller also persists freeTop().
 class OrderPool {
-    std::vector<Order> pool_;
-    std::vector<Order*> freeList_;
+    std::vector<Order>     ownedSlots_;
+    std::vector<OrderSlot> ownedFree_;
+    Order*     slots_;
+    OrderSlot* free_;
+    size_t     top_;        // free entries in free_
+    size_t     capacity_;
 public:
-    explicit OrderPool(size_t capacity) : pool_(capacity) {
-        freeList_.reserve(capacity);
+    explicit OrderPool(size_t capacity)
+        : ownedSlots_(capacity + 1)
+        , ownedFree_(capacity)
+        , slots_(ownedSlots_.data())
+        , free_(ownedFree_.data())
+        , top_(capacity)
+        , capacity_(capacity)
+    {
+        // Slot 1 is handed out first
         for (size_t i = 0; i < capacity; ++i) {
-            freeList_.push_back(&pool_[i]);
+            ownedFree_[i] = static_cast<OrderSlot>(capacity - i);
         }
     }
 
+    // Non-owning: capacity + 1 slots and a free list holding `freeTop` entries
+    OrderPool(Order* slots, OrderSlot* freeList, size_t freeTop, size_t capacity)
+        : slots_(slots), free_(freeList), top_(freeTop), capacity_(capacity) {}
+
     Order* alloc() {
-        assert(!freeList_.empty() && "OrderPool exhausted");
-        Order* p = freeList_.back();
-        freeList_.pop_back();
-        return p;
+        assert(top_ > 0 && "OrderPool exhausted");
+        return &slots_[free_[--top_]];
     }
 
     void dealloc(Order* p) {
-        freeList_.push_back(p);
+        free_[top_++] = slotOf(p);
     }
 
+    OrderSlot slotOf(const Order* p) const { return static_cast<OrderSlot>(p - slots_); }
+    Order*    slots() const { return slots_; }
+
+    size_t capacity() const { return capacity_; }
+    size_t inUse()    const { return capacity_ - top_; }
+    size_t freeTop()  const { return top_; }
+
     OrderPool(const OrderPool&) = delete;
     OrderPool& operator=(const OrderPool&) = delete;
+    // Owned storage moves with its buffers, so slots_ / free_ stay valid
     OrderPool(OrderPool&&) = default;
     OrderPool& operator=(OrderPool&&) = default;
 };
 
-class OrderBook {
+// Price-time priority book. `Levels` is the per-side price level index
+// (see PriceLevelIndex.h) and `Stats` the instrumentation policy (see
+// BookStats.h). The definitions live in OrderBook.cpp and are explicitly
+// instantiated for the combinations aliased below.
+template <typename Levels, typename Stats = NoBookStats>
+class BasicOrderBook {
 public:
-    explicit OrderBook(size_t poolCapacity = 1'048'576);
-
-    OrderResult addOrder(Side side, OrderType type, Price price, Quantity quantity);
+    static constexpr Price kMinPrice = Levels::kMinPrice;
+    static constexpr Price kMaxPrice = Levels::kMaxPrice;
+
+    explicit BasicOrderBook(size_t poolCapacity = 1'048'576);
+
+    // Hosted in a shared-memory segment (see SharedBook.h): a fresh one from
+    // SharedBookSegment::create, or an existing one reopened writable after a
+    // restart, in which case resting orders, depth and OrderIds carry on.
+    // Stats and trade stats are process-local and start empty, except pool
+    // occupancy, which starts from the segment's resting orders. The segment
+    // must be mapped writable (segment.writable()); the process aborts otherwise.
+    explicit BasicOrderBook(SharedBookSegment&& segment)
+        requires std::is_same_v<Levels, DenseLevelIndex>;
+    ~BasicOrderBook();
+
+    // Not copyable or movable: the stats hold atomics read by other threads,
+    // and a shared-memory book owns its segment's single-writer lock. Hold
+    // books by pointer (or construct in place) where they must be relocated.
+    BasicOrderBook(const BasicOrderBook&) = delete;
+    BasicOrderBook& operator=(const BasicOrderBook&) = delete;
+
+    // `owner` identifies the participant for self-trade prevention; `stp`
+    // decides what happens if this order meets a resting order of the same
+    // owner (see SelfTradePrevention). NO_OWNER disables the check.
+    // Rejected with orderId 0, and nothing changed, only if a shared-memory
+    // book's OrderId index cannot grow (segment at its limit or not extendable).
+    OrderResult addOrder(Side side, OrderType type, Price price, Quantity quantity,
+                         OwnerId owner = NO_OWNER,
+                         SelfTradePrevention stp = SelfTradePrevention::CancelResting);
     bool cancelOrder(OrderId id);
 
+    // Select how executions are reported in OrderResult. In Conflated mode
+    // `fills` stays empty and `levelFills` carries one entry per price level;
+    // the optional handler is invoked once per maker execution instead.
+    void setFillReporting(FillReporting mode, MakerExecutionHandler handler = nullptr,
+                          void* context = nullptr);
+    FillReporting fillReporting() const { return fillReporting_; }
+
+    // Resting orders reduced or cancelled by self-trade prevention are
+    // reported here, in the order they were met
+    void setSelfTradeHandler(SelfTradeHandler handler, void* context = nullptr);
+
     std::vector<PriceLevel> getBids(size_t depth = 10) const;
     std::vector<PriceLevel> getAsks(size_t depth = 10) const;
 
+    // Market-impact queries: read-only, allocation-free, answered from the
+    // per-level quantity arrays without touching individual orders.
+    FillEstimate estimateBuy(Quantity quantity) const;    // sweep asks
+    FillEstimate estimateSell(Quantity quantity) const;   // sweep bids
+    uint64_t bidQuantityWithin(Price ticks) const;        // [bestBid - ticks, bestBid]
+    uint64_t askQuantityWithin(Price ticks) const;        // [bestAsk, bestAsk + ticks]
+
     size_t bidLevelCount() const { return numBidLevels_; }
     size_t askLevelCount() const { return numAskLevels_; }
     size_t orderCount()    const { return numOrders_; }
 
+    // Bytes held by the two price level indexes (excludes the order pool)
+    size_t levelMemoryBytes() const { return bids_.memoryBytes() + asks_.memoryBytes(); }
+
+    // Instrumentation; snapshot() may be called from any thread
+    const Stats& stats() const { return stats_; }
+
+    // Last price, session OHLC, volume, VWAP and rolling bars, maintained by
+    // the matching loop; snapshot() may be called from any thread
+    const TradeStats& tradeStats() const { return tradeStats_; }
+    void setBarInterval(std::chrono::nanoseconds interval) { tradeStats_.setBarInterval(interval); }
+
 private:
+    template <FillReporting Mode>
     void matchOrder(Order* order, OrderResult& result);
+    template <FillReporting Mode, bool SelfTradeCheck>
+    void matchLevel(Order* order, PriceLevelList& level, LevelQuantity& levelQty,
+                    OrderResult& result, TradeTally& tally);
+    void preventSelfTrade(Order* order, PriceLevelList& level, LevelQuantity& levelQty,
+                          OrderSlot restingSlot, OrderResult& result);
+    void releaseResting(PriceLevelList& level, OrderSlot slot);
     void updateBestBidDown();
     void updateBestAskUp();
+    bool growIndex(size_t id);
 
-    // Flat arrays for price levels (#3: std::map -> flat array)
-    std::vector<PriceLevelList> bidLevels_;
-    std::vector<PriceLevelList> askLevels_;
+    // Shared-memory books bracket each operation so inspectors and a
+    // restarting engine can tell a consistent segment from a torn one
+    void beginUpdate();
+    void endUpdate();
+
+    static size_t levelOf(Price price) { return static_cast<size_t>(price - kMinPrice); }
+
+    // Price levels per side (#3: std::map -> flat array, or paged for wide ranges)
+    Levels bids_;
+    Levels asks_;
 
     // Best price tracking
-    Price bestBid_ = MIN_PRICE - 1;   // sentinel: no bids
-    Price bestAsk_ = MAX_PRICE + 1;   // sentinel: no asks
+    Price bestBid_ = kMinPrice - 1;   // sentinel: no bids
+    Price bestAsk_ = kMaxPrice + 1;   // sentinel: no asks
 
-    // O(1) order lookup by OrderId (#4: unordered_map -> flat vector)
-    std::vector<Order*> orders_;
+    // O(1) order lookup by OrderId (#4: unordered_map -> flat vector): pool
+    // slot, NO_ORDER when not resting. Owned, or in the shared segment.
+    std::vector<OrderSlot> ownedIndex_;
+    OrderSlot* index_     = nullptr;
+    size_t     indexSize_ = 0;
 
     // Object pool (#2: heap allocation -> pre-allocated pool)
     OrderPool pool_;
 
+    // Execution reporting (see setFillReporting)
+    FillReporting         fillReporting_ = FillReporting::PerOrder;
+    MakerExecutionHandler makerHandler_  = nullptr;
+    void*                 makerContext_  = nullptr;
+    SelfTradeHandler      selfTradeHandler_ = nullptr;
+    void*                 selfTradeContext_ = nullptr;
+
     // Counters
     size_t numBidLevels_ = 0;
     size_t numAskLevels_ = 0;
     size_t numOrders_ = 0;
 
     OrderId nextId_ = 1;
+
+    [[no_unique_address]] Stats stats_;
+
+    TradeStats tradeStats_;
+
+    std::unique_ptr<SharedBookSegment> segment_;   // null unless shared-memory hosted
 };
 
+// Dense flat arrays over [MIN_PRICE, MAX_PRICE]
+using OrderBook = BasicOrderBook<DenseLevelIndex>;
+
+// Lazily allocated pages over [0, 2^24) ticks
+using PagedOrderBook = BasicOrderBook<PagedLevelIndex<>>;
+
+// Same layouts with hot-path counters and histograms enabled
+using InstrumentedOrderBook      = BasicOrderBook<DenseLevelIndex, BookStats>;
+using InstrumentedPagedOrderBook = BasicOrderBook<PagedLevelIndex<>, BookStats>;
+
 } // namespace orderbook
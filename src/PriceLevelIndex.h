@@ -0,0 +1,247 @@
+#pragma once
+
+#include "Order.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace orderbook {
+
+// Price range for flat array indexing
+constexpr Price  MIN_PRICE = 0;
+constexpr Price  MAX_PRICE = 20000;
+constexpr size_t NUM_PRICE_LEVELS = static_cast<size_t>(MAX_PRICE - MIN_PRICE) + 1;
+
+// Intrusive doubly-linked list for orders at a single price level. Links are
+// pool slots, resolved against the pool's slot array passed to each call.
+struct PriceLevelList {
+    OrderSlot head  = NO_ORDER;
+    OrderSlot tail  = NO_ORDER;
+    uint32_t  count = 0;
+
+    bool empty() const { return head == NO_ORDER; }
+
+    void pushBack(Order* slots, OrderSlot s) {
+        Order& order = slots[s];
+        order.prev = tail;
+        order.next = NO_ORDER;
+        if (tail != NO_ORDER) slots[tail].next = s;
+        else head = s;
+        tail = s;
+        ++count;
+    }
+
+    void remove(Order* slots, OrderSlot s) {
+        Order& order = slots[s];
+        if (order.prev != NO_ORDER) slots[order.prev].next = order.next;
+        else head = order.next;
+        if (order.next != NO_ORDER) slots[order.next].prev = order.prev;
+        else tail = order.prev;
+        order.prev = NO_ORDER;
+        order.next = NO_ORDER;
+        --count;
+    }
+
+    OrderSlot front() const { return head; }
+};
+
+static_assert(std::is_trivially_copyable_v<PriceLevelList>);
+
+// ---------------------------------------------------------------------------
+// Level indexes: one side of the book, addressed by level offset
+// (price - kMinPrice). A level is non-empty iff its quantity is non-zero:
+// resting orders hold at least 1 and the 64-bit LevelQuantity cannot wrap
+// (at most 2^32 orders of at most 2^32 - 1 each), so scans test quantity.
+//
+//   level(i) / quantity(i)   mutable access; the level must be materialized
+//   materialize(i)           called before the first order rests at i
+//   levelAdded(i)            i went empty -> non-empty
+//   levelRemoved(i)          i went non-empty -> empty
+//   quantityAt(i)            resting quantity, 0 if never materialized
+//   scanUp(i) / scanDown(i)  nearest non-empty level at or beyond i, or npos
+//   sumQuantity(lo, hi)      total resting quantity over [lo, hi]
+// ---------------------------------------------------------------------------
+
+// Flat arrays covering [MIN_PRICE, MAX_PRICE], allocated up front
+// (#3: std::map -> flat array). PriceLevelList and quantity are kept in
+// separate arrays (SoA) so scans stream over a dense quantity array. The
+// arrays are owned, or placed by the caller (shared-memory books).
+class DenseLevelIndex {
+public:
+    static constexpr Price  kMinPrice  = MIN_PRICE;
+    static constexpr Price  kMaxPrice  = MAX_PRICE;
+    static constexpr size_t kNumLevels = NUM_PRICE_LEVELS;
+    static constexpr size_t npos       = static_cast<size_t>(-1);
+
+    DenseLevelIndex()
+        : ownedLevels_(kNumLevels)
+        , ownedQty_(kNumLevels, 0)
+        , levels_(ownedLevels_.data())
+        , qty_(ownedQty_.data())
+    {}
+
+    // Non-owning: kNumLevels zero-initialized (or previously used) entries each
+    DenseLevelIndex(PriceLevelList* levels, LevelQuantity* qty) : levels_(levels), qty_(qty) {}
+
+    DenseLevelIndex(const DenseLevelIndex&) = delete;
+    DenseLevelIndex& operator=(const DenseLevelIndex&) = delete;
+
+    PriceLevelList&       level(size_t i)          { return levels_[i]; }
+    const PriceLevelList& level(size_t i) const    { return levels_[i]; }
+    LevelQuantity&        quantity(size_t i)       { return qty_[i]; }
+    LevelQuantity         quantityAt(size_t i) const { return qty_[i]; }
+
+    void materialize(size_t) {}
+    void levelAdded(size_t) {}
+    void levelRemoved(size_t) {}
+
+    size_t scanUp(size_t i) const {
+        while (i < kNumLevels && qty_[i] == 0) ++i;
+        return i < kNumLevels ? i : npos;
+    }
+
+    size_t scanDown(size_t i) const {
+        while (i != npos && qty_[i] == 0) --i;
+        return i;
+    }
+
+    // Straight-line sum over a contiguous slice: no early exit, no branches,
+    // so the compiler vectorizes it.
+    uint64_t sumQuantity(size_t lo, size_t hi) const {
+        uint64_t total = 0;
+        for (size_t i = lo; i <= hi; ++i) {
+            total += qty_[i];
+        }
+        return total;
+    }
+
+    size_t memoryBytes() const { return bytesFor(kNumLevels); }
+
+    // Bytes a dense index over `levels` ticks would hold
+    static constexpr size_t bytesFor(size_t levels) {
+        return levels * (sizeof(PriceLevelList) + sizeof(LevelQuantity));
+    }
+
+private:
+    std::vector<PriceLevelList> ownedLevels_;   // empty when non-owning
+    std::vector<LevelQuantity>  ownedQty_;
+    PriceLevelList*             levels_;
+    LevelQuantity*              qty_;
+};
+
+// Two-level paged index for instruments with millions of possible ticks.
+// A directory of page pointers covers the whole range; a page of
+// 2^PageBits levels is allocated the first time an order rests in it and
+// returned to a small spare pool when its last level empties. Lookup is two
+// array indexes; scans skip absent pages in one step.
+template <Price MaxPrice = (Price{1} << 24) - 1, unsigned PageBits = 9>
+class PagedLevelIndex {
+public:
+    static constexpr Price  kMinPrice  = 0;
+    static constexpr Price  kMaxPrice  = MaxPrice;
+    static constexpr size_t kNumLevels = static_cast<size_t>(kMaxPrice - kMinPrice) + 1;
+    static constexpr size_t npos       = static_cast<size_t>(-1);
+
+    static constexpr size_t kPageSize  = size_t{1} << PageBits;
+    static constexpr size_t kPageMask  = kPageSize - 1;
+    static constexpr size_t kNumPages  = (kNumLevels + kPageSize - 1) / kPageSize;
+    static constexpr size_t kMaxSparePages = 16;
+
+    PagedLevelIndex() : directory_(kNumPages) {}
+
+    PriceLevelList&       level(size_t i)       { return directory_[i >> PageBits]->levels[i & kPageMask]; }
+    const PriceLevelList& level(size_t i) const { return directory_[i >> PageBits]->levels[i & kPageMask]; }
+    LevelQuantity&        quantity(size_t i)    { return directory_[i >> PageBits]->qty[i & kPageMask]; }
+
+    LevelQuantity quantityAt(size_t i) const {
+        const Page* page = directory_[i >> PageBits].get();
+        return page ? page->qty[i & kPageMask] : 0;
+    }
+
+    void materialize(size_t i) {
+        auto& slot = directory_[i >> PageBits];
+        if (slot) [[likely]] return;
+        if (!spare_.empty()) {
+            slot = std::move(spare_.back());
+            spare_.pop_back();
+        } else {
+            slot = std::make_unique<Page>();
+        }
+        ++livePages_;
+    }
+
+    void levelAdded(size_t i) { ++directory_[i >> PageBits]->occupied; }
+
+    void levelRemoved(size_t i) {
+        auto& slot = directory_[i >> PageBits];
+        if (--slot->occupied != 0) [[likely]] return;
+        // Every level in the page is empty again, so it can be reused as-is
+        if (spare_.size() < kMaxSparePages) spare_.push_back(std::move(slot));
+        else slot.reset();
+        --livePages_;
+    }
+
+    size_t scanUp(size_t i) const {
+        while (i < kNumLevels) {
+            const Page* page = directory_[i >> PageBits].get();
+            if (page) {
+                for (size_t j = i & kPageMask; j < kPageSize; ++j) {
+                    if (page->qty[j] != 0) return (i & ~kPageMask) | j;
+                }
+            }
+            i = (i | kPageMask) + 1;
+        }
+        return npos;
+    }
+
+    size_t scanDown(size_t i) const {
+        while (i != npos) {
+            const Page* page = directory_[i >> PageBits].get();
+            if (page) {
+                for (size_t j = (i & kPageMask) + 1; j-- > 0;) {
+                    if (page->qty[j] != 0) return (i & ~kPageMask) | j;
+                }
+            }
+            i = (i & ~kPageMask) - 1;
+        }
+        return npos;
+    }
+
+    uint64_t sumQuantity(size_t lo, size_t hi) const {
+        uint64_t total = 0;
+        while (lo <= hi) {
+            size_t pageEnd = std::min(lo | kPageMask, hi);
+            if (const Page* page = directory_[lo >> PageBits].get()) {
+                for (size_t j = lo & kPageMask; j <= (pageEnd & kPageMask); ++j) {
+                    total += page->qty[j];
+                }
+            }
+            lo = pageEnd + 1;
+        }
+        return total;
+    }
+
+    size_t livePages() const { return livePages_; }
+
+    size_t memoryBytes() const {
+        return directory_.capacity() * sizeof(directory_[0])
+             + (livePages_ + spare_.size()) * sizeof(Page);
+    }
+
+private:
+    struct alignas(64) Page {
+        PriceLevelList levels[kPageSize];
+        LevelQuantity  qty[kPageSize] = {};
+        size_t         occupied = 0;   // non-empty levels in this page
+    };
+
+    std::vector<std::unique_ptr<Page>> directory_;
+    std::vector<std::unique_ptr<Page>> spare_;
+    size_t livePages_ = 0;
+};
+
+} // namespace orderbook
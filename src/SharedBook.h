@@ -0,0 +1,396 @@
+#pragma once
+
+// Shared-memory hosting for OrderBook (dense level layout).
+//
+// A named POSIX shared-memory segment holds the complete book state, so a
+// restarted engine reattaches instead of rebuilding, and read-only inspector
+// processes can view depth without touching the matching thread. Nothing in
+// the segment is a pointer: orders link by pool slot (see Order.h), the
+// OrderId index stores slots, and every region is found by its offset.
+//
+// Layout (each region 64-byte aligned):
+//   SharedBookHeader            layout guards, offsets, book scalars, seq
+//   Order     slots[capacity+1] slot 0 is the NO_ORDER sentinel
+//   OrderSlot freeList[capacity]
+//   PriceLevelList / LevelQuantity  bid levels, bid quantities, ask levels, ask quantities
+//   OrderSlot index[...]        OrderId -> slot; last, grown in place
+//
+// The writer maps the index with room for SHARED_BOOK_MAX_INDEX entries so
+// growth is an ftruncate and nothing moves. `seq` is odd while the engine is
+// inside addOrder / cancelOrder: inspectors retry around it, and attaching a
+// writer to a segment left odd (the engine died mid-operation) fails. One
+// writer at a time is enforced with an advisory lock. POSIX only; on other
+// platforms create() and open() return false.
+
+#include "Order.h"
+#include "PriceLevelIndex.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace orderbook {
+
+constexpr uint32_t SHARED_BOOK_VERSION   = 3;
+constexpr uint64_t SHARED_BOOK_MAX_INDEX = uint64_t{1} << 32;   // OrderIds per segment
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "seq must be address-free");
+
+struct SharedBookHeader {
+    char     magic[8];
+    uint32_t version;
+    uint32_t orderBytes;        // sizeof(Order), PriceLevelList, LevelQuantity: layout guards
+    uint32_t levelBytes;
+    uint32_t quantityBytes;
+    Price    minPrice;
+    Price    maxPrice;
+    uint64_t poolCapacity;
+
+    uint64_t slotsOffset;
+    uint64_t freeListOffset;
+    uint64_t bidLevelsOffset;
+    uint64_t bidQtyOffset;
+    uint64_t askLevelsOffset;
+    uint64_t askQtyOffset;
+    uint64_t indexOffset;       // == bytes before the index
+
+    std::atomic<uint64_t> seq;  // odd while an operation is in progress
+    std::atomic<uint64_t> indexEntries;
+
+    // Book scalars, written by the engine at the end of every operation
+    uint64_t freeTop;
+    Price    bestBid;
+    Price    bestAsk;
+    uint64_t numBidLevels;
+    uint64_t numAskLevels;
+    uint64_t numOrders;
+    uint64_t nextId;
+};
+
+constexpr char SHARED_BOOK_MAGIC[8] = {'O', 'B', 'S', 'H', 'B', 'O', 'O', 'K'};
+
+// Owns one mapping of a segment. Move-only.
+class SharedBookSegment {
+public:
+    SharedBookSegment() = default;
+    SharedBookSegment(SharedBookSegment&& other) noexcept { *this = std::move(other); }
+    SharedBookSegment& operator=(SharedBookSegment&& other) noexcept {
+        if (this != &other) {
+            release();
+            name_     = std::move(other.name_);
+            fd_       = other.fd_;
+            base_     = other.base_;
+            mapped_   = other.mapped_;
+            writable_ = other.writable_;
+            other.fd_   = -1;
+            other.base_ = nullptr;
+        }
+        return *this;
+    }
+    SharedBookSegment(const SharedBookSegment&) = delete;
+    SharedBookSegment& operator=(const SharedBookSegment&) = delete;
+    ~SharedBookSegment() { release(); }
+
+    // New, empty book for `poolCapacity` resting orders. An existing segment
+    // of that name is replaced only if it is stale (no writer attached);
+    // while a writer holds it, create fails. `name` is a POSIX shm name ("/book").
+    static bool create(const std::string& name, size_t poolCapacity, SharedBookSegment& out);
+
+    // Existing segment. Writable: a restarting engine (exclusive, fails if
+    // the last writer stopped mid-operation). Read-only: inspectors.
+    static bool open(const std::string& name, bool writable, SharedBookSegment& out);
+
+    static bool remove(const std::string& name);
+
+    bool valid() const { return base_ != nullptr; }
+    bool writable() const { return valid() && writable_; }
+    const std::string& name() const { return name_; }
+    SharedBookHeader& header() const { return *reinterpret_cast<SharedBookHeader*>(base_); }
+
+    template <typename T>
+    T* at(uint64_t offset) const { return reinterpret_cast<T*>(base_ + offset); }
+
+    Order*          slots() const     { return at<Order>(header().slotsOffset); }
+    OrderSlot*      freeList() const  { return at<OrderSlot>(header().freeListOffset); }
+    PriceLevelList* bidLevels() const { return at<PriceLevelList>(header().bidLevelsOffset); }
+    LevelQuantity*  bidQty() const    { return at<LevelQuantity>(header().bidQtyOffset); }
+    PriceLevelList* askLevels() const { return at<PriceLevelList>(header().askLevelsOffset); }
+    LevelQuantity*  askQty() const    { return at<LevelQuantity>(header().askQtyOffset); }
+    OrderSlot*      index() const     { return at<OrderSlot>(header().indexOffset); }
+
+    // Writer: extend the index to `entries` (new entries read NO_ORDER)
+    bool growIndex(uint64_t entries);
+
+    // Writer: bracket every mutation of the segment
+    void beginWrite() {
+        auto& seq = header().seq;
+        seq.store(seq.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+    void endWrite() {
+        auto& seq = header().seq;
+        seq.store(seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+private:
+    static uint64_t align64(uint64_t n) { return (n + 63) & ~uint64_t{63}; }
+    bool map(size_t bytes);
+    void release();
+
+    std::string name_;
+    int         fd_       = -1;
+    std::byte*  base_     = nullptr;
+    size_t      mapped_   = 0;
+    bool        writable_ = false;
+};
+
+// Consistent read-only copy of a shared book's top levels
+struct SharedBookSnapshot {
+    Price    bestBid;            // sentinels as in OrderBook when a side is empty
+    Price    bestAsk;
+    uint64_t numOrders;
+    uint64_t numBidLevels;
+    uint64_t numAskLevels;
+    uint64_t nextId;
+    uint64_t poolInUse;
+    uint64_t poolCapacity;
+    std::vector<PriceLevel> bids;
+    std::vector<PriceLevel> asks;
+};
+
+// Inspector side: maps a segment read-only and copies depth under `seq`,
+// retrying while the engine is mid-operation. Never writes to the segment.
+class SharedBookView {
+public:
+    bool open(const std::string& name) { return SharedBookSegment::open(name, false, segment_); }
+
+    // False if the engine kept the book busy for `maxRetries` attempts
+    bool snapshot(size_t depth, SharedBookSnapshot& out, int maxRetries = 1000) const {
+        const SharedBookHeader& h = segment_.header();
+        for (int attempt = 0; attempt < maxRetries; ++attempt) {
+            uint64_t begin = h.seq.load(std::memory_order_acquire);
+            if (begin & 1) continue;
+
+            // The engine writes these concurrently; volatile keeps every read
+            // real, and a changed seq discards the copy
+            const volatile SharedBookHeader& v = h;
+            out.bestBid      = v.bestBid;
+            out.bestAsk      = v.bestAsk;
+            out.numOrders    = v.numOrders;
+            out.numBidLevels = v.numBidLevels;
+            out.numAskLevels = v.numAskLevels;
+            out.nextId       = v.nextId;
+            out.poolCapacity = h.poolCapacity;
+            out.poolInUse    = h.poolCapacity - v.freeTop;
+
+            collect(segment_.bidLevels(), segment_.bidQty(), out.bestBid, out.numBidLevels,
+                    depth, -1, out.bids);
+            collect(segment_.askLevels(), segment_.askQty(), out.bestAsk, out.numAskLevels,
+                    depth, +1, out.asks);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (h.seq.load(std::memory_order_relaxed) == begin) return true;
+        }
+        return false;
+    }
+
+private:
+    static void collect(const PriceLevelList* levels, const LevelQuantity* qty, Price best,
+                        uint64_t numLevels, size_t depth, int step, std::vector<PriceLevel>& out) {
+        out.clear();
+        if (best < MIN_PRICE || best > MAX_PRICE) return;   // empty side sentinel
+        const volatile LevelQuantity*  q = qty;
+        const volatile PriceLevelList* l = levels;
+        depth = std::min<size_t>(depth, static_cast<size_t>(numLevels));
+        for (Price p = best; p >= MIN_PRICE && p <= MAX_PRICE && out.size() < depth; p += step) {
+            size_t i = static_cast<size_t>(p - MIN_PRICE);
+            LevelQuantity total = q[i];
+            if (total != 0) out.push_back({p, total, l[i].count});
+        }
+    }
+
+    SharedBookSegment segment_;
+};
+
+// ---------------------------------------------------------------------------
+
+inline bool SharedBookSegment::map(size_t bytes) {
+#ifndef _WIN32
+    int prot = writable_ ? (PROT_READ | PROT_WRITE) : PROT_READ;
+    void* p = mmap(nullptr, bytes, prot, MAP_SHARED | MAP_NORESERVE, fd_, 0);
+    if (p == MAP_FAILED) return false;
+    base_   = static_cast<std::byte*>(p);
+    mapped_ = bytes;
+    return true;
+#else
+    (void)bytes;
+    return false;
+#endif
+}
+
+inline void SharedBookSegment::release() {
+#ifndef _WIN32
+    if (base_) munmap(base_, mapped_);
+    if (fd_ >= 0) close(fd_);   // also drops the writer lock
+#endif
+    base_ = nullptr;
+    fd_   = -1;
+}
+
+inline bool SharedBookSegment::create(const std::string& name, size_t poolCapacity,
+                                      SharedBookSegment& out) {
+#ifndef _WIN32
+    if (poolCapacity == 0 || poolCapacity >= SHARED_BOOK_MAX_INDEX - 1) return false;
+
+    SharedBookHeader layout{};
+    uint64_t offset = align64(sizeof(SharedBookHeader));
+    auto place = [&offset](uint64_t bytes) {
+        uint64_t at = offset;
+        offset = align64(offset + bytes);
+        return at;
+    };
+    layout.slotsOffset     = place((poolCapacity + 1) * sizeof(Order));
+    layout.freeListOffset  = place(poolCapacity * sizeof(OrderSlot));
+    layout.bidLevelsOffset = place(NUM_PRICE_LEVELS * sizeof(PriceLevelList));
+    layout.bidQtyOffset    = place(NUM_PRICE_LEVELS * sizeof(LevelQuantity));
+    layout.askLevelsOffset = place(NUM_PRICE_LEVELS * sizeof(PriceLevelList));
+    layout.askQtyOffset    = place(NUM_PRICE_LEVELS * sizeof(LevelQuantity));
+    layout.indexOffset     = offset;
+    const uint64_t indexEntries = poolCapacity + 1;
+
+    // An earlier session's segment may be left behind: unlink it only if
+    // its writer lock is free, never under a running engine
+    int existing = shm_open(name.c_str(), O_RDWR, 0);
+    if (existing >= 0) {
+        bool stale = flock(existing, LOCK_EX | LOCK_NB) == 0;
+        if (stale) shm_unlink(name.c_str());
+        close(existing);
+        if (!stale) return false;
+    }
+
+    SharedBookSegment seg;
+    seg.name_     = name;
+    seg.writable_ = true;
+    seg.fd_ = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (seg.fd_ < 0) return false;   // created concurrently: not ours to remove
+    if (flock(seg.fd_, LOCK_EX | LOCK_NB) != 0 ||
+        ftruncate(seg.fd_, static_cast<off_t>(offset + indexEntries * sizeof(OrderSlot))) != 0 ||
+        !seg.map(offset + SHARED_BOOK_MAX_INDEX * sizeof(OrderSlot))) {
+        seg.release();
+        shm_unlink(name.c_str());
+        return false;
+    }
+
+    // ftruncate zero-fills: levels, quantities and the index start empty
+    auto* h = new (seg.base_) SharedBookHeader{};
+    std::memcpy(h->magic, SHARED_BOOK_MAGIC, sizeof(h->magic));
+    h->version         = SHARED_BOOK_VERSION;
+    h->orderBytes      = sizeof(Order);
+    h->levelBytes      = sizeof(PriceLevelList);
+    h->quantityBytes   = sizeof(LevelQuantity);
+    h->minPrice        = MIN_PRICE;
+    h->maxPrice        = MAX_PRICE;
+    h->poolCapacity    = poolCapacity;
+    h->slotsOffset     = layout.slotsOffset;
+    h->freeListOffset  = layout.freeListOffset;
+    h->bidLevelsOffset = layout.bidLevelsOffset;
+    h->bidQtyOffset    = layout.bidQtyOffset;
+    h->askLevelsOffset = layout.askLevelsOffset;
+    h->askQtyOffset    = layout.askQtyOffset;
+    h->indexOffset     = layout.indexOffset;
+    h->indexEntries.store(indexEntries, std::memory_order_relaxed);
+    h->freeTop      = poolCapacity;
+    h->bestBid      = MIN_PRICE - 1;
+    h->bestAsk      = MAX_PRICE + 1;
+    h->nextId       = 1;
+
+    OrderSlot* freeList = seg.freeList();
+    for (size_t i = 0; i < poolCapacity; ++i) {
+        freeList[i] = static_cast<OrderSlot>(poolCapacity - i);   // slot 1 allocated first
+    }
+    h->seq.store(0, std::memory_order_release);
+
+    out = std::move(seg);
+    return true;
+#else
+    (void)name; (void)poolCapacity; (void)out;
+    return false;
+#endif
+}
+
+inline bool SharedBookSegment::open(const std::string& name, bool writable, SharedBookSegment& out) {
+#ifndef _WIN32
+    SharedBookSegment seg;
+    seg.name_     = name;
+    seg.writable_ = writable;
+    seg.fd_ = shm_open(name.c_str(), writable ? O_RDWR : O_RDONLY, 0);
+    struct stat st{};
+    if (seg.fd_ < 0 || (writable && flock(seg.fd_, LOCK_EX | LOCK_NB) != 0) ||
+        fstat(seg.fd_, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(SharedBookHeader) ||
+        !seg.map(sizeof(SharedBookHeader))) {
+        return false;
+    }
+
+    const SharedBookHeader& h = seg.header();
+    bool ok = std::memcmp(h.magic, SHARED_BOOK_MAGIC, sizeof(h.magic)) == 0 &&
+              h.version == SHARED_BOOK_VERSION && h.orderBytes == sizeof(Order) &&
+              h.levelBytes == sizeof(PriceLevelList) && h.quantityBytes == sizeof(LevelQuantity) &&
+              h.minPrice == MIN_PRICE &&
+              h.maxPrice == MAX_PRICE && static_cast<uint64_t>(st.st_size) >= h.indexOffset;
+    if (!ok || (writable && (h.seq.load(std::memory_order_acquire) & 1))) return false;
+
+    // Remap at full size: the writer reserves room for index growth,
+    // inspectors only need the part before the index
+    uint64_t indexOffset = h.indexOffset;
+    munmap(seg.base_, seg.mapped_);
+    seg.base_ = nullptr;
+    if (!seg.map(writable ? indexOffset + SHARED_BOOK_MAX_INDEX * sizeof(OrderSlot) : indexOffset)) {
+        return false;
+    }
+
+    out = std::move(seg);
+    return true;
+#else
+    (void)name; (void)writable; (void)out;
+    return false;
+#endif
+}
+
+inline bool SharedBookSegment::remove(const std::string& name) {
+#ifndef _WIN32
+    return shm_unlink(name.c_str()) == 0;
+#else
+    (void)name;
+    return false;
+#endif
+}
+
+inline bool SharedBookSegment::growIndex(uint64_t entries) {
+#ifndef _WIN32
+    SharedBookHeader& h = header();
+    if (entries > SHARED_BOOK_MAX_INDEX) return false;
+    if (ftruncate(fd_, static_cast<off_t>(h.indexOffset + entries * sizeof(OrderSlot))) != 0) {
+        return false;
+    }
+    h.indexEntries.store(entries, std::memory_order_relaxed);
+    return true;
+#else
+    (void)entries;
+    return false;
+#endif
+}
+
+} // namespace orderbook
@@ -0,0 +1,222 @@
+#pragma once
+
+#include "Types.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace orderbook {
+
+// Incremental trade statistics maintained by the matching loop: last price,
+// session OHLC, volume, notional (VWAP) and trade count, plus rolling
+// time-bucket bars. The session is the book's lifetime.
+//
+// Cost on the matching thread: a handful of min/max/add operations per
+// price level swept (all fills at one level share a price) into a stack
+// TradeTally, then one fold + seqlock publish per aggressive order that
+// traded. Readers on any thread get a consistent snapshot by copying under
+// the sequence counter and retrying if the writer published meanwhile.
+
+constexpr size_t TRADE_BAR_HISTORY = 64;
+
+struct TradeBar {
+    int64_t  start;       // bucket start, steady_clock nanoseconds since epoch
+    Price    open;
+    Price    high;
+    Price    low;
+    Price    close;
+    uint64_t volume;
+    int64_t  notional;    // sum(price * quantity)
+    uint64_t trades;
+
+    double vwap() const { return volume ? static_cast<double>(notional) / volume : 0.0; }
+};
+
+struct TradeStatsSnapshot {
+    uint64_t trades    = 0;    // maker executions
+    uint64_t volume    = 0;
+    int64_t  notional  = 0;
+    Price    lastPrice = 0;    // OHLC and last are 0 until the first trade
+    Price    open      = 0;
+    Price    high      = 0;
+    Price    low       = 0;
+
+    // Bars that saw trades, oldest first; bars[numBars - 1] is the current
+    // one. Buckets without trades have no bar.
+    size_t numBars = 0;
+    std::array<TradeBar, TRADE_BAR_HISTORY> bars{};
+
+    double vwap() const { return volume ? static_cast<double>(notional) / volume : 0.0; }
+};
+
+// Running totals for one aggressive order. Lives on the matching stack so
+// the per-level updates stay in registers.
+struct TradeTally {
+    Price    open     = 0;
+    Price    last     = 0;
+    Price    high     = std::numeric_limits<Price>::min();
+    Price    low      = std::numeric_limits<Price>::max();
+    uint64_t volume   = 0;
+    int64_t  notional = 0;
+    uint64_t trades   = 0;
+
+    // `count` maker executions totalling `quantity` at `price`
+    void add(Price price, Quantity quantity, uint32_t count) {
+        open      = trades ? open : price;
+        last      = price;
+        high      = std::max(high, price);
+        low       = std::min(low, price);
+        volume   += quantity;
+        notional += static_cast<int64_t>(quantity) * price;
+        trades   += count;
+    }
+};
+
+class TradeStats {
+public:
+    explicit TradeStats(std::chrono::nanoseconds barInterval = std::chrono::seconds(1))
+        : barInterval_(std::max<int64_t>(barInterval.count(), 1)) {}
+
+    // Writer only. The next trade opens a new bar.
+    void setBarInterval(std::chrono::nanoseconds interval) {
+        barInterval_ = std::max<int64_t>(interval.count(), 1);
+        barOpen_     = false;
+    }
+    std::chrono::nanoseconds barInterval() const { return std::chrono::nanoseconds(barInterval_); }
+
+    // Matching thread: fold one aggressive order's trades in and publish
+    void onMatchEnd(const TradeTally& tally, Timestamp when) {
+        if (tally.trades == 0) return;
+        commit(tally, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          when.time_since_epoch()).count());
+    }
+
+    // Any thread
+    TradeStatsSnapshot snapshot() const {
+        TradeStatsSnapshot s;
+        for (;;) {
+            uint64_t begin = seq_.load(std::memory_order_acquire);
+            if (begin & 1) continue;   // publish in progress
+
+            s.trades    = load(pubTrades_);
+            s.volume    = load(pubVolume_);
+            s.notional  = load(pubNotional_);
+            s.lastPrice = load(pubLast_);
+            s.open      = load(pubOpen_);
+            s.high      = load(pubHigh_);
+            s.low       = load(pubLow_);
+            s.numBars   = load(pubNumBars_);
+            size_t head = load(pubHead_);
+            for (size_t i = 0; i < s.numBars; ++i) {
+                s.bars[i] = pubBars_[(head + TRADE_BAR_HISTORY + 1 - s.numBars + i) % TRADE_BAR_HISTORY].load();
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq_.load(std::memory_order_relaxed) == begin) return s;
+        }
+    }
+
+private:
+    template <typename T>
+    using Cell = std::atomic<T>;
+
+    struct PublishedBar {
+        Cell<int64_t>  start{0};
+        Cell<Price>    open{0}, high{0}, low{0}, close{0};
+        Cell<uint64_t> volume{0};
+        Cell<int64_t>  notional{0};
+        Cell<uint64_t> trades{0};
+
+        void store(const TradeBar& b) {
+            set(start, b.start);
+            set(open, b.open);
+            set(high, b.high);
+            set(low, b.low);
+            set(close, b.close);
+            set(volume, b.volume);
+            set(notional, b.notional);
+            set(trades, b.trades);
+        }
+        TradeBar load() const {
+            return {TradeStats::load(start), TradeStats::load(open), TradeStats::load(high),
+                    TradeStats::load(low), TradeStats::load(close), TradeStats::load(volume),
+                    TradeStats::load(notional), TradeStats::load(trades)};
+        }
+    };
+
+    template <typename T>
+    static T load(const Cell<T>& c) { return c.load(std::memory_order_relaxed); }
+    template <typename T>
+    static void set(Cell<T>& c, T v) { c.store(v, std::memory_order_relaxed); }
+
+    void commit(const TradeTally& t, int64_t nowNs) {
+        // Session
+        if (trades_ == 0) open_ = t.open;
+        high_      = trades_ ? std::max(high_, t.high) : t.high;
+        low_       = trades_ ? std::min(low_, t.low) : t.low;
+        trades_   += t.trades;
+        volume_   += t.volume;
+        notional_ += t.notional;
+
+        // Current bar: roll when the aggressive order falls in a new bucket
+        int64_t bucket = nowNs / barInterval_;
+        if (!barOpen_ || bucket != barBucket_) {
+            if (numBars_ > 0) head_ = (head_ + 1) % TRADE_BAR_HISTORY;
+            numBars_   = std::min(numBars_ + 1, TRADE_BAR_HISTORY);
+            barBucket_ = bucket;
+            barOpen_   = true;
+            bar_ = {bucket * barInterval_, t.open, t.high, t.low, t.last, 0, 0, 0};
+        }
+        bar_.high      = std::max(bar_.high, t.high);
+        bar_.low       = std::min(bar_.low, t.low);
+        bar_.close     = t.last;
+        bar_.volume   += t.volume;
+        bar_.notional += t.notional;
+        bar_.trades   += t.trades;
+
+        // Publish (single writer seqlock)
+        uint64_t s = seq_.load(std::memory_order_relaxed);
+        seq_.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        set(pubTrades_, trades_);
+        set(pubVolume_, volume_);
+        set(pubNotional_, notional_);
+        set(pubLast_, t.last);
+        set(pubOpen_, open_);
+        set(pubHigh_, high_);
+        set(pubLow_, low_);
+        set(pubHead_, head_);
+        set(pubNumBars_, numBars_);
+        pubBars_[head_].store(bar_);
+        seq_.store(s + 2, std::memory_order_release);
+    }
+
+    // Writer-only: folded session and current bar
+    uint64_t trades_   = 0;
+    uint64_t volume_   = 0;
+    int64_t  notional_ = 0;
+    Price    open_ = 0, high_ = 0, low_ = 0;
+    int64_t  barInterval_;
+    int64_t  barBucket_ = 0;
+    bool     barOpen_   = false;
+    TradeBar bar_{};
+    size_t   head_    = 0;
+    size_t   numBars_ = 0;
+
+    // Published for readers, guarded by seq_ (odd while a publish is in progress)
+    alignas(64) Cell<uint64_t> seq_{0};
+    Cell<uint64_t> pubTrades_{0};
+    Cell<uint64_t> pubVolume_{0};
+    Cell<int64_t>  pubNotional_{0};
+    Cell<Price>    pubLast_{0}, pubOpen_{0}, pubHigh_{0}, pubLow_{0};
+    Cell<size_t>   pubHead_{0};
+    Cell<size_t>   pubNumBars_{0};
+    std::array<PublishedBar, TRADE_BAR_HISTORY> pubBars_{};
+};
+
+} // namespace orderbook
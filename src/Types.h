@@ -9,7 +9,11 @@ namespace orderbook {
 using OrderId   = uint64_t;
 using Price     = int64_t;   // Fixed-point: actual price * 100 (e.g., 10050 = $100.50)
 using Quantity  = uint32_t;
+using LevelQuantity = uint64_t;   // resting total at one price level; cannot wrap
 using Timestamp = std::chrono::steady_clock::time_point;
+using OwnerId   = uint32_t;  // participant for self-trade prevention
+
+constexpr OwnerId NO_OWNER = 0;   // never considered a self-trade
 
 enum class Side : uint8_t {
     Buy,
@@ -21,10 +25,37 @@ enum class OrderType : uint8_t {
     Market
 };
 
+// What happens when an aggressive order meets a resting order with the same
+// owner. The aggressor's mode applies; no trade is printed either way.
+enum class SelfTradePrevention : uint8_t {
+    CancelResting,     // cancel the resting order and keep matching (default)
+    CancelAggressor,   // cancel the aggressor's remaining quantity
+    CancelBoth,
+    Decrement          // reduce both by the smaller quantity; whichever reaches 0 is cancelled
+};
+
+enum class FillReporting : uint8_t {
+    PerOrder,   // one Fill per resting order touched (default)
+    Conflated   // one LevelFill per price level swept
+};
+
 struct PriceLevel {
-    Price    price;
-    Quantity totalQuantity;
-    size_t   orderCount;
+    Price         price;
+    LevelQuantity totalQuantity;
+    size_t        orderCount;
+};
+
+// Outcome of walking one side of the book for a hypothetical aggressive order.
+// Computed from level aggregates only; the book is not modified.
+struct FillEstimate {
+    Quantity filledQuantity;  // < requested when the side runs out of liquidity
+    int64_t  notional;        // sum(price * quantity) over the levels swept
+    Price    worstPrice;      // last (deepest) level touched
+    size_t   levelsSwept;
+
+    double vwap() const {
+        return filledQuantity ? static_cast<double>(notional) / filledQuantity : 0.0;
+    }
 };
 
 struct Fill {
@@ -34,11 +65,30 @@ struct Fill {
     Quantity quantity;
 };
 
+// Aggregated execution at one price level (FillReporting::Conflated)
+struct LevelFill {
+    Price    price;
+    Quantity quantity;
+    uint32_t makerCount;
+};
+
+// Per-maker execution callback for conflated reporting. Invoked inside the
+// matching loop, so it must not call back into the OrderBook.
+using MakerExecutionHandler = void (*)(void* context, OrderId makerOrderId,
+                                       Quantity filledQuantity, Quantity leavesQuantity);
+
+// Self-trade prevention callback: a resting order lost `quantity` without
+// trading (`leavesQuantity` 0: it was cancelled). Same constraints as above.
+using SelfTradeHandler = void (*)(void* context, OrderId restingOrderId,
+                                  Quantity quantity, Quantity leavesQuantity);
+
 struct OrderResult {
-    OrderId            orderId;
-    Quantity           filledQuantity;
-    Quantity           remainingQuantity;
-    std::vector<Fill>  fills;
+    OrderId                 orderId;
+    Quantity                filledQuantity;
+    Quantity                remainingQuantity;
+    std::vector<Fill>       fills;
+    std::vector<LevelFill>  levelFills;   // Conflated mode only
+    Quantity                selfTradeQuantity;   // cancelled by self-trade prevention
 };
 
 } // namespace orderbook
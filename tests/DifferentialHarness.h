@@ -0,0 +1,269 @@
+#pragma once
+
+// Differential harness: decodes a byte string into an order command stream,
+// drives an optimized book and ReferenceBook with it in lockstep, and
+// compares results, depth, best prices, impact queries and trade statistics
+// after every step.
+// Shared by the randomized unit tests and the libFuzzer entry point.
+//
+// Each command is 8 bytes:
+//   [0]    op: 0-3 limit, 4 market, 5-6 cancel, 7 toggle fill reporting
+//   [1]    bit 0 side, bit 1 wide price band (+-2000 ticks instead of +-64),
+//          bits 2-3 owner (0 = none), bits 4-5 self-trade prevention mode,
+//          bit 6 extreme sizes (quantity near 2^31, impact probes near the
+//          type limits), bit 7 boundary price (within 3 ticks of kMinPrice
+//          or kMaxPrice)
+//   [2..3] price offset from mid
+//   [4..5] quantity (0..199)
+//   [6..7] cancel target (recent id, or an arbitrary one if bit 15 is set);
+//          also drives the impact-query parameters
+
+#include "OrderBook.h"
+#include "ReferenceBook.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace orderbook {
+
+constexpr size_t DIFF_COMMAND_BYTES = 8;
+
+namespace detail {
+
+struct Execution {
+    OrderId  maker;
+    Quantity quantity;
+    Quantity leaves;
+};
+
+inline void recordExecution(void* ctx, OrderId maker, Quantity qty, Quantity leaves) {
+    static_cast<std::vector<Execution>*>(ctx)->push_back({maker, qty, leaves});
+}
+
+inline bool sameExecutions(const std::vector<Execution>& a, const std::vector<Execution>& b) {
+    return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const auto& x, const auto& y) {
+        return x.maker == y.maker && x.quantity == y.quantity && x.leaves == y.leaves;
+    });
+}
+
+inline bool sameLevels(const std::vector<PriceLevel>& a, const std::vector<PriceLevel>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].price != b[i].price || a[i].totalQuantity != b[i].totalQuantity ||
+            a[i].orderCount != b[i].orderCount) {
+            return false;
+        }
+    }
+    return true;
+}
+
+inline bool sameEstimate(const FillEstimate& a, const FillEstimate& b) {
+    return a.filledQuantity == b.filledQuantity && a.notional == b.notional &&
+           a.levelsSwept == b.levelsSwept && (a.levelsSwept == 0 || a.worstPrice == b.worstPrice);
+}
+
+// Collapse per-order reference fills into the conflated per-level view
+inline std::vector<LevelFill> conflate(const std::vector<Fill>& fills) {
+    std::vector<LevelFill> out;
+    for (const auto& f : fills) {
+        if (out.empty() || out.back().price != f.price) out.push_back({f.price, 0, 0});
+        out.back().quantity += f.quantity;
+        ++out.back().makerCount;
+    }
+    return out;
+}
+
+} // namespace detail
+
+template <typename Book>
+std::string runDifferential(const uint8_t* data, size_t size, Price mid = 10'240) {
+    using namespace detail;
+
+    const size_t numCommands = size / DIFF_COMMAND_BYTES;
+    Book book(numCommands + 1);
+    ReferenceBook ref;
+
+    std::vector<Execution> executions;
+    std::vector<Execution> selfTrades, refSelfTrades;   // resting orders reduced by STP
+    book.setSelfTradeHandler(&recordExecution, &selfTrades);
+    ref.setSelfTradeHandler(&recordExecution, &refSelfTrades);
+    bool conflated = false;
+    OrderId issued = 0;
+    TradeStatsSnapshot tape;   // session stats rebuilt from reference fills
+    std::ostringstream err;
+
+    auto u16 = [](const uint8_t* p) { return static_cast<uint32_t>(p[0] | (p[1] << 8)); };
+
+    for (size_t step = 0; step < numCommands; ++step) {
+        const uint8_t* cmd = data + step * DIFF_COMMAND_BYTES;
+        const uint8_t op  = cmd[0] % 8;
+        const Side   side = (cmd[1] & 1) ? Side::Sell : Side::Buy;
+        const bool   wide = (cmd[1] & 2) != 0;
+        const OwnerId owner = (cmd[1] >> 2) & 3;
+        const auto   stp  = static_cast<SelfTradePrevention>((cmd[1] >> 4) & 3);
+        const bool   extreme  = (cmd[1] & 0x40) != 0;
+        const bool   boundary = (cmd[1] & 0x80) != 0;
+        const uint32_t rawPrice = u16(cmd + 2);
+        const uint32_t rawQty   = u16(cmd + 4);
+        const uint32_t rawRef   = u16(cmd + 6);
+
+        err << "step " << step << " ";
+
+        if (op <= 4) {
+            OrderType type = (op == 4) ? OrderType::Market : OrderType::Limit;
+            const Price inward = static_cast<Price>((rawPrice >> 1) % 4);
+            Price price = (type == OrderType::Market) ? 0
+                        : boundary ? ((rawPrice & 1) ? Book::kMaxPrice - inward
+                                                     : Book::kMinPrice + inward)
+                        : wide ? mid + static_cast<Price>(rawPrice % 4001) - 2000
+                               : mid + static_cast<Price>(rawPrice % 129) - 64;
+            // Two extreme orders at one level total more than 2^32
+            Quantity qty = extreme ? (Quantity{1} << 31) + rawQty % 256 - 128 : rawQty % 200;
+            err << (type == OrderType::Market ? "market " : "limit ")
+                << (side == Side::Buy ? "buy " : "sell ") << qty << "@" << price
+                << " owner " << owner << " stp " << static_cast<int>(stp) << ": ";
+
+            executions.clear();
+            selfTrades.clear();
+            refSelfTrades.clear();
+            OrderResult got  = book.addOrder(side, type, price, qty, owner, stp);
+            OrderResult want = ref.addOrder(side, type, price, qty, owner, stp);
+            ++issued;
+
+            if (got.orderId != want.orderId || got.filledQuantity != want.filledQuantity ||
+                got.remainingQuantity != want.remainingQuantity ||
+                got.selfTradeQuantity != want.selfTradeQuantity) {
+                err << "result mismatch: filled " << got.filledQuantity << " vs "
+                    << want.filledQuantity << ", remaining " << got.remainingQuantity
+                    << " vs " << want.remainingQuantity << ", self-trade cancelled "
+                    << got.selfTradeQuantity << " vs " << want.selfTradeQuantity;
+                return err.str();
+            }
+
+            if (!sameExecutions(selfTrades, refSelfTrades)) {
+                err << "self-trade reductions mismatch (" << selfTrades.size() << " vs "
+                    << refSelfTrades.size() << ")";
+                return err.str();
+            }
+
+            if (!conflated) {
+                if (got.fills.size() != want.fills.size()) {
+                    err << "fill count " << got.fills.size() << " vs " << want.fills.size();
+                    return err.str();
+                }
+                for (size_t i = 0; i < got.fills.size(); ++i) {
+                    const Fill& a = got.fills[i];
+                    const Fill& b = want.fills[i];
+                    if (a.makerOrderId != b.makerOrderId || a.takerOrderId != b.takerOrderId ||
+                        a.price != b.price || a.quantity != b.quantity) {
+                        err << "fill " << i << " mismatch: maker " << a.makerOrderId << " vs "
+                            << b.makerOrderId << ", " << a.quantity << "@" << a.price << " vs "
+                            << b.quantity << "@" << b.price;
+                        return err.str();
+                    }
+                }
+            } else {
+                auto levels = conflate(want.fills);
+                bool same = got.fills.empty() && got.levelFills.size() == levels.size() &&
+                            executions.size() == want.fills.size();
+                for (size_t i = 0; same && i < levels.size(); ++i) {
+                    same = got.levelFills[i].price == levels[i].price &&
+                           got.levelFills[i].quantity == levels[i].quantity &&
+                           got.levelFills[i].makerCount == levels[i].makerCount;
+                }
+                for (size_t i = 0; same && i < executions.size(); ++i) {
+                    same = executions[i].maker == want.fills[i].makerOrderId &&
+                           executions[i].quantity == want.fills[i].quantity;
+                }
+                if (!same) {
+                    err << "conflated fills mismatch (" << got.levelFills.size() << " levels, "
+                        << executions.size() << " executions vs " << levels.size() << ", "
+                        << want.fills.size() << ")";
+                    return err.str();
+                }
+            }
+
+            for (const Fill& f : want.fills) {
+                if (tape.trades == 0) tape.open = tape.high = tape.low = f.price;
+                tape.high = std::max(tape.high, f.price);
+                tape.low  = std::min(tape.low, f.price);
+                tape.lastPrice = f.price;
+                tape.volume   += f.quantity;
+                tape.notional += static_cast<int64_t>(f.quantity) * f.price;
+                ++tape.trades;
+            }
+            TradeStatsSnapshot ts = book.tradeStats().snapshot();
+            if (ts.trades != tape.trades || ts.volume != tape.volume ||
+                ts.notional != tape.notional || ts.lastPrice != tape.lastPrice ||
+                ts.open != tape.open || ts.high != tape.high || ts.low != tape.low) {
+                err << "trade stats mismatch: trades " << ts.trades << " vs " << tape.trades
+                    << ", volume " << ts.volume << " vs " << tape.volume << ", last "
+                    << ts.lastPrice << " vs " << tape.lastPrice << ", high/low " << ts.high
+                    << "/" << ts.low << " vs " << tape.high << "/" << tape.low;
+                return err.str();
+            }
+        } else if (op <= 6) {
+            OrderId target = (rawRef & 0x8000) || issued == 0
+                           ? static_cast<OrderId>(rawRef & 0x7fff)
+                           : issued - (rawRef % std::min<OrderId>(issued, 64));
+            err << "cancel " << target << ": ";
+            bool got  = book.cancelOrder(target);
+            bool want = ref.cancelOrder(target);
+            if (got != want) {
+                err << "returned " << got << " vs " << want;
+                return err.str();
+            }
+        } else {
+            conflated = !conflated;
+            err << "fill reporting -> " << (conflated ? "conflated" : "per-order") << ": ";
+            book.setFillReporting(conflated ? FillReporting::Conflated : FillReporting::PerOrder,
+                                  conflated ? &recordExecution : nullptr, &executions);
+        }
+
+        // Book state after the step
+        if (book.orderCount() != ref.orderCount() ||
+            book.bidLevelCount() != ref.bidLevelCount() ||
+            book.askLevelCount() != ref.askLevelCount()) {
+            err << "counts: orders " << book.orderCount() << " vs " << ref.orderCount()
+                << ", bid levels " << book.bidLevelCount() << " vs " << ref.bidLevelCount()
+                << ", ask levels " << book.askLevelCount() << " vs " << ref.askLevelCount();
+            return err.str();
+        }
+
+        // Full depth (level counts already agree), which also pins best bid / best ask
+        if (!sameLevels(book.getBids(book.bidLevelCount()), ref.getBids(ref.bidLevelCount()))) {
+            err << "bid depth mismatch";
+            return err.str();
+        }
+        if (!sameLevels(book.getAsks(book.askLevelCount()), ref.getAsks(ref.askLevelCount()))) {
+            err << "ask depth mismatch";
+            return err.str();
+        }
+
+        // Impact queries
+        Quantity probeQty   = extreme ? std::numeric_limits<Quantity>::max() - rawRef
+                                      : (rawRef % 512) * 4;
+        Price    probeTicks = extreme ? std::numeric_limits<Price>::max() - rawRef
+                                      : static_cast<Price>(rawRef % 97);
+        if (!sameEstimate(book.estimateBuy(probeQty), ref.estimateBuy(probeQty)) ||
+            !sameEstimate(book.estimateSell(probeQty), ref.estimateSell(probeQty))) {
+            err << "estimate mismatch for qty " << probeQty;
+            return err.str();
+        }
+        if (book.bidQuantityWithin(probeTicks) != ref.bidQuantityWithin(probeTicks) ||
+            book.askQuantityWithin(probeTicks) != ref.askQuantityWithin(probeTicks)) {
+            err << "quantity-within mismatch for " << probeTicks << " ticks";
+            return err.str();
+        }
+
+        err.str("");
+    }
+
+    return {};
+}
+
+} // namespace orderbook
@@ -0,0 +1,27 @@
+// libFuzzer entry point for the differential harness.
+//
+//   cmake -B build-fuzz -DORDERBOOK_FUZZ=ON -DCMAKE_CXX_COMPILER=clang++
+//   cmake --build build-fuzz --target fuzz_orderbook
+//   ./build-fuzz/fuzz_orderbook -max_len=8192 corpus/
+
+#include "DifferentialHarness.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+using namespace orderbook;
+
+template <typename Book>
+static void check(const char* name, const uint8_t* data, size_t size) {
+    std::string err = runDifferential<Book>(data, size);
+    if (!err.empty()) {
+        std::fprintf(stderr, "%s diverged from ReferenceBook at %s\n", name, err.c_str());
+        std::abort();
+    }
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    check<OrderBook>("OrderBook", data, size);
+    check<PagedOrderBook>("PagedOrderBook", data, size);
+    return 0;
+}
@@ -0,0 +1,199 @@
+#pragma once
+
+// Deliberately simple price-time priority book used as the oracle for
+// differential testing: std::map levels, std::list queues, no pools, no
+// flat arrays. Mirrors OrderBook's public behavior, including OrderId
+// assignment (every add consumes an id), market-order discard and
+// self-trade prevention.
+
+#include "Types.h"
+
+#include <algorithm>
+#include <functional>
+#include <list>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace orderbook {
+
+class ReferenceBook {
+public:
+    OrderResult addOrder(Side side, OrderType type, Price price, Quantity quantity,
+                         OwnerId owner = NO_OWNER,
+                         SelfTradePrevention stp = SelfTradePrevention::CancelResting) {
+        OrderResult result{};
+        result.orderId = nextId_++;
+        Quantity remaining = quantity;
+
+        if (side == Side::Buy) {
+            match(asks_, remaining, owner, stp, result, [&](Price best) {
+                return type == OrderType::Market || price >= best;
+            });
+        } else {
+            match(bids_, remaining, owner, stp, result, [&](Price best) {
+                return type == OrderType::Market || price <= best;
+            });
+        }
+
+        result.filledQuantity    = quantity - remaining - result.selfTradeQuantity;
+        result.remainingQuantity = remaining;
+
+        if (remaining > 0 && type == OrderType::Limit) {
+            if (side == Side::Buy) bids_[price].push_back({result.orderId, remaining, owner});
+            else                   asks_[price].push_back({result.orderId, remaining, owner});
+            index_[result.orderId] = {side, price};
+        }
+        return result;
+    }
+
+    void setSelfTradeHandler(SelfTradeHandler handler, void* context = nullptr) {
+        selfTradeHandler_ = handler;
+        selfTradeContext_ = context;
+    }
+
+    bool cancelOrder(OrderId id) {
+        auto it = index_.find(id);
+        if (it == index_.end()) return false;
+        auto [side, price] = it->second;
+        index_.erase(it);
+        if (side == Side::Buy) return eraseFrom(bids_, price, id);
+        return eraseFrom(asks_, price, id);
+    }
+
+    std::vector<PriceLevel> getBids(size_t depth) const { return levels(bids_, depth); }
+    std::vector<PriceLevel> getAsks(size_t depth) const { return levels(asks_, depth); }
+
+    FillEstimate estimateBuy(Quantity quantity) const { return estimate(asks_, quantity); }
+    FillEstimate estimateSell(Quantity quantity) const { return estimate(bids_, quantity); }
+
+    uint64_t bidQuantityWithin(Price ticks) const {
+        if (bids_.empty() || ticks < 0) return 0;
+        const Price best = bids_.begin()->first;
+        uint64_t total = 0;
+        for (const auto& [p, q] : bids_) {
+            if (best - p > ticks) break;   // distance, so huge ticks cannot overflow
+            total += sum(q);
+        }
+        return total;
+    }
+
+    uint64_t askQuantityWithin(Price ticks) const {
+        if (asks_.empty() || ticks < 0) return 0;
+        const Price best = asks_.begin()->first;
+        uint64_t total = 0;
+        for (const auto& [p, q] : asks_) {
+            if (p - best > ticks) break;
+            total += sum(q);
+        }
+        return total;
+    }
+
+    size_t bidLevelCount() const { return bids_.size(); }
+    size_t askLevelCount() const { return asks_.size(); }
+    size_t orderCount()    const { return index_.size(); }
+
+private:
+    struct Resting {
+        OrderId  id;
+        Quantity quantity;
+        OwnerId  owner;
+    };
+    using Queue = std::list<Resting>;
+
+    template <typename Levels, typename Crosses>
+    void match(Levels& levels, Quantity& remaining, OwnerId owner, SelfTradePrevention stp,
+               OrderResult& result, Crosses crosses) {
+        while (remaining > 0 && !levels.empty() && crosses(levels.begin()->first)) {
+            auto& [price, queue] = *levels.begin();
+            while (remaining > 0 && !queue.empty()) {
+                Resting& maker = queue.front();
+                if (owner != NO_OWNER && maker.owner == owner) {
+                    preventSelfTrade(remaining, maker, stp, result);
+                } else {
+                    Quantity qty = std::min(remaining, maker.quantity);
+                    result.fills.push_back({maker.id, result.orderId, price, qty});
+                    remaining      -= qty;
+                    maker.quantity -= qty;
+                }
+                if (maker.quantity == 0) {
+                    index_.erase(maker.id);
+                    queue.pop_front();
+                }
+            }
+            if (queue.empty()) levels.erase(levels.begin());
+        }
+    }
+
+    void preventSelfTrade(Quantity& remaining, Resting& maker, SelfTradePrevention stp,
+                                 OrderResult& result) {
+        Quantity makerCut = 0;
+        Quantity takerCut = 0;
+        if (stp == SelfTradePrevention::CancelResting) {
+            makerCut = maker.quantity;
+        } else if (stp == SelfTradePrevention::CancelAggressor) {
+            takerCut = remaining;
+        } else if (stp == SelfTradePrevention::CancelBoth) {
+            makerCut = maker.quantity;
+            takerCut = remaining;
+        } else {
+            makerCut = takerCut = std::min(remaining, maker.quantity);
+        }
+        remaining                -= takerCut;
+        result.selfTradeQuantity += takerCut;
+        if (makerCut > 0) {
+            maker.quantity -= makerCut;
+            if (selfTradeHandler_) selfTradeHandler_(selfTradeContext_, maker.id, makerCut, maker.quantity);
+        }
+    }
+
+    template <typename Levels>
+    static bool eraseFrom(Levels& levels, Price price, OrderId id) {
+        auto lvl = levels.find(price);
+        auto& queue = lvl->second;
+        queue.remove_if([id](const Resting& r) { return r.id == id; });
+        if (queue.empty()) levels.erase(lvl);
+        return true;
+    }
+
+    static uint64_t sum(const Queue& q) {
+        uint64_t total = 0;
+        for (const auto& r : q) total += r.quantity;
+        return total;
+    }
+
+    template <typename Levels>
+    static std::vector<PriceLevel> levels(const Levels& levels, size_t depth) {
+        std::vector<PriceLevel> out;
+        for (const auto& [p, q] : levels) {
+            if (out.size() == depth) break;
+            out.push_back({p, sum(q), q.size()});
+        }
+        return out;
+    }
+
+    template <typename Levels>
+    static FillEstimate estimate(const Levels& levels, Quantity quantity) {
+        FillEstimate est{0, 0, 0, 0};
+        Quantity remaining = quantity;
+        for (const auto& [p, q] : levels) {
+            if (remaining == 0) break;
+            Quantity take = static_cast<Quantity>(std::min<uint64_t>(remaining, sum(q)));
+            est.notional += static_cast<int64_t>(take) * p;
+            est.worstPrice = p;
+            ++est.levelsSwept;
+            remaining -= take;
+        }
+        est.filledQuantity = quantity - remaining;
+        return est;
+    }
+
+    std::map<Price, Queue, std::greater<>> bids_;
+    std::map<Price, Queue>                 asks_;
+    std::unordered_map<OrderId, std::pair<Side, Price>> index_;
+    OrderId nextId_ = 1;
+    SelfTradeHandler selfTradeHandler_ = nullptr;
+    void*            selfTradeContext_ = nullptr;
+};
+
+} // namespace orderbook
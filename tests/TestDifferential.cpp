@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include "DifferentialHarness.h"
+#include "SharedBook.h"
+
+#include <cstdlib>
+#include <random>
+#include <string>
+
+using namespace orderbook;
+
+// Randomized differential tests: each optimized book must agree with
+// ReferenceBook on every fill, depth level and query, step by step.
+
+namespace {
+
+#ifndef _WIN32
+// Dense book hosted in a private shared-memory segment. The name is
+// unlinked straight away; the mapping lives as long as the book.
+class SharedOrderBook : public OrderBook {
+public:
+    explicit SharedOrderBook(size_t poolCapacity) : OrderBook(segment(poolCapacity)) {}
+
+private:
+    static SharedBookSegment segment(size_t poolCapacity) {
+        static int counter = 0;
+        std::string name = "/ob_diff_" + std::to_string(getpid()) + "_" + std::to_string(counter++);
+        SharedBookSegment seg;
+        if (!SharedBookSegment::create(name, poolCapacity, seg)) std::abort();
+        SharedBookSegment::remove(name);
+        return seg;
+    }
+};
+#endif
+
+} // namespace
+
+template <typename Book>
+class DifferentialTest : public ::testing::Test {};
+
+#ifndef _WIN32
+using BookTypes = ::testing::Types<OrderBook, PagedOrderBook, InstrumentedOrderBook, SharedOrderBook>;
+#else
+using BookTypes = ::testing::Types<OrderBook, PagedOrderBook, InstrumentedOrderBook>;
+#endif
+TYPED_TEST_SUITE(DifferentialTest, BookTypes);
+
+namespace {
+
+std::vector<uint8_t> randomCommands(uint32_t seed, size_t commands) {
+    std::mt19937 rng(seed);
+    std::vector<uint8_t> bytes(commands * DIFF_COMMAND_BYTES);
+    for (auto& b : bytes) b = static_cast<uint8_t>(rng());
+    return bytes;
+}
+
+} // namespace
+
+TYPED_TEST(DifferentialTest, RandomStreamsMatchReference) {
+    for (uint32_t seed = 1; seed <= 100; ++seed) {
+        auto bytes = randomCommands(seed, 1000);
+        std::string err = runDifferential<TypeParam>(bytes.data(), bytes.size());
+        ASSERT_TRUE(err.empty()) << "seed " << seed << ": " << err;
+    }
+}
+
+TYPED_TEST(DifferentialTest, SweepThenRefillAcrossPageBoundary) {
+    // Rest asks one tick apart on both sides of a 512-tick page boundary,
+    // sweep them with market buys, then refill; exercises best-price
+    // recovery, page release and reuse.
+    std::vector<uint8_t> bytes;
+    auto push = [&](uint8_t op, uint8_t flags, uint16_t price, uint16_t qty, uint16_t ref) {
+        uint8_t cmd[DIFF_COMMAND_BYTES] = {
+            op, flags,
+            static_cast<uint8_t>(price), static_cast<uint8_t>(price >> 8),
+            static_cast<uint8_t>(qty),   static_cast<uint8_t>(qty >> 8),
+            static_cast<uint8_t>(ref),   static_cast<uint8_t>(ref >> 8)};
+        bytes.insert(bytes.end(), cmd, cmd + DIFF_COMMAND_BYTES);
+    };
+    for (int round = 0; round < 3; ++round) {
+        for (uint16_t p = 54; p < 75; ++p) push(0, 1, p, 10, 0);   // asks at mid-10 .. mid+10
+        push(4, 0, 0, 150, 0);                                      // market buy
+        push(7, 0, 0, 0, 0);                                        // toggle reporting
+        push(4, 0, 0, 199, 0);
+        push(5, 0, 0, 0, 3);                                        // cancel a recent id
+    }
+    std::string err = runDifferential<TypeParam>(bytes.data(), bytes.size());
+    EXPECT_TRUE(err.empty()) << err;
+}
@@ -1,8 +1,25 @@
 #include <gtest/gtest.h>
 #include "OrderBook.h"
+#include "SharedBook.h"
+
+#include <atomic>
+#include <limits>
+#include <random>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+#ifndef _WIN32
+#include <csignal>
+#include <sys/resource.h>
+#endif
 
 using namespace orderbook;
 
+static_assert(std::is_move_constructible_v<OrderPool> && std::is_move_assignable_v<OrderPool>,
+              "an owning pool can be relocated");
+static_assert(!std::is_move_constructible_v<OrderBook>, "books stay where they were built");
+
 class OrderBookTest : public ::testing::Test {
 protected:
     OrderBook book;
@@ -208,3 +225,708 @@ TEST_F(OrderBookTest, MarketOrderExceedsLiquidity) {
     // Unfilled market order quantity is discarded
     EXPECT_EQ(book.orderCount(), 0);
 }
+
+TEST_F(OrderBookTest, EstimateBuySweepsLevels) {
+    book.addOrder(Side::Sell, OrderType::Limit, 10000, 50);
+    book.addOrder(Side::Sell, OrderType::Limit, 10000, 50);
+    book.addOrder(Side::Sell, OrderType::Limit, 10002, 100);
+
+    auto est = book.estimateBuy(150);
+    EXPECT_EQ(est.filledQuantity, 150);
+    EXPECT_EQ(est.levelsSwept, 2);
+    EXPECT_EQ(est.worstPrice, 10002);
+    EXPECT_EQ(est.notional, 100 * 10000 + 50 * 10002);
+    EXPECT_DOUBLE_EQ(est.vwap(), (100.0 * 10000 + 50.0 * 10002) / 150);
+
+    // Query must not modify the book
+    EXPECT_EQ(book.orderCount(), 3);
+    auto result = book.addOrder(Side::Buy, OrderType::Market, 0, 150);
+    EXPECT_EQ(result.filledQuantity, est.filledQuantity);
+}
+
+TEST_F(OrderBookTest, EstimateSellExceedsLiquidity) {
+    book.addOrder(Side::Buy, OrderType::Limit, 10000, 30);
+    book.addOrder(Side::Buy, OrderType::Limit,  9990, 20);
+
+    auto est = book.estimateSell(100);
+    EXPECT_EQ(est.filledQuantity, 50);
+    EXPECT_EQ(est.levelsSwept, 2);
+    EXPECT_EQ(est.worstPrice, 9990);
+
+    EXPECT_EQ(book.estimateBuy(100).filledQuantity, 0);
+}
+
+TEST_F(OrderBookTest, QuantityWithinTicks) {
+    book.addOrder(Side::Buy,  OrderType::Limit, 10000, 10);
+    book.addOrder(Side::Buy,  OrderType::Limit,  9995, 20);
+    book.addOrder(Side::Buy,  OrderType::Limit,  9980, 40);
+    book.addOrder(Side::Sell, OrderType::Limit, 10010, 5);
+    auto r = book.addOrder(Side::Sell, OrderType::Limit, 10013, 7);
+
+    EXPECT_EQ(book.bidQuantityWithin(0), 10);
+    EXPECT_EQ(book.bidQuantityWithin(5), 30);
+    EXPECT_EQ(book.bidQuantityWithin(100), 70);
+    EXPECT_EQ(book.askQuantityWithin(3), 12);
+
+    // Aggregates track cancels and partial fills
+    book.cancelOrder(r.orderId);
+    book.addOrder(Side::Sell, OrderType::Market, 0, 15);
+    EXPECT_EQ(book.askQuantityWithin(3), 5);
+    EXPECT_EQ(book.bidQuantityWithin(5), 15);
+
+    // Ranges running past either end of the price range are clamped
+    constexpr Price kHuge = std::numeric_limits<Price>::max();
+    EXPECT_EQ(book.askQuantityWithin(kHuge), book.askQuantityWithin(MAX_PRICE));
+    EXPECT_EQ(book.bidQuantityWithin(kHuge), book.bidQuantityWithin(MAX_PRICE));
+}
+
+// Two orders of 2^31 make a level total of exactly 2^32, which a 32-bit
+// aggregate would read as empty
+TEST_F(OrderBookTest, LevelTotalOf2To32) {
+    constexpr Quantity kHalf = Quantity{1} << 31;
+    book.addOrder(Side::Sell, OrderType::Limit, 10000, 10);
+    book.addOrder(Side::Sell, OrderType::Limit, 10005, kHalf);
+    book.addOrder(Side::Sell, OrderType::Limit, 10005, kHalf);
+    book.addOrder(Side::Buy, OrderType::Market, 0, 10);
+
+    EXPECT_EQ(book.askLevelCount(), 1);
+    auto asks = book.getAsks(10);
+    ASSERT_EQ(asks.size(), 1);
+    EXPECT_EQ(asks[0].price, 10005);
+    EXPECT_EQ(asks[0].orderCount, 2);
+    EXPECT_EQ(asks[0].totalQuantity, uint64_t{1} << 32);
+    EXPECT_EQ(book.askQuantityWithin(10), uint64_t{1} << 32);
+
+    auto est = book.estimateBuy(std::numeric_limits<Quantity>::max());
+    EXPECT_EQ(est.filledQuantity, std::numeric_limits<Quantity>::max());
+    EXPECT_EQ(est.levelsSwept, 1);
+    EXPECT_EQ(est.worstPrice, 10005);
+
+    // Must trade, not rest crossed
+    auto result = book.addOrder(Side::Buy, OrderType::Limit, 10010, 100);
+    EXPECT_EQ(result.filledQuantity, 100);
+    EXPECT_EQ(book.bidLevelCount(), 0);
+}
+
+TEST_F(OrderBookTest, ConflatedFillsOnePerLevel) {
+    struct Exec { OrderId maker; Quantity qty; Quantity leaves; };
+    std::vector<Exec> execs;
+    book.setFillReporting(FillReporting::Conflated,
+        [](void* ctx, OrderId maker, Quantity qty, Quantity leaves) {
+            static_cast<std::vector<Exec>*>(ctx)->push_back({maker, qty, leaves});
+        }, &execs);
+
+    auto m1 = book.addOrder(Side::Sell, OrderType::Limit, 10000, 30);
+    auto m2 = book.addOrder(Side::Sell, OrderType::Limit, 10000, 20);
+    auto m3 = book.addOrder(Side::Sell, OrderType::Limit, 10001, 40);
+
+    auto result = book.addOrder(Side::Buy, OrderType::Market, 0, 70);
+    EXPECT_EQ(result.filledQuantity, 70);
+    EXPECT_TRUE(result.fills.empty());
+    ASSERT_EQ(result.levelFills.size(), 2);
+    EXPECT_EQ(result.levelFills[0].price, 10000);
+    EXPECT_EQ(result.levelFills[0].quantity, 50);
+    EXPECT_EQ(result.levelFills[0].makerCount, 2);
+    EXPECT_EQ(result.levelFills[1].price, 10001);
+    EXPECT_EQ(result.levelFills[1].quantity, 20);
+    EXPECT_EQ(result.levelFills[1].makerCount, 1);
+
+    ASSERT_EQ(execs.size(), 3);
+    EXPECT_EQ(execs[0].maker, m1.orderId);
+    EXPECT_EQ(execs[1].maker, m2.orderId);
+    EXPECT_EQ(execs[2].maker, m3.orderId);
+    EXPECT_EQ(execs[2].qty, 20);
+    EXPECT_EQ(execs[2].leaves, 20);
+
+    // Switching back restores per-order fills
+    book.setFillReporting(FillReporting::PerOrder);
+    result = book.addOrder(Side::Buy, OrderType::Market, 0, 20);
+    EXPECT_EQ(result.fills.size(), 1);
+    EXPECT_TRUE(result.levelFills.empty());
+}
+
+TEST_F(OrderBookTest, TradeStatsSessionAndVwap) {
+    EXPECT_EQ(book.tradeStats().snapshot().trades, 0);
+
+    book.addOrder(Side::Sell, OrderType::Limit, 10000, 30);
+    book.addOrder(Side::Sell, OrderType::Limit, 10000, 20);
+    book.addOrder(Side::Sell, OrderType::Limit, 10002, 40);
+    book.addOrder(Side::Buy,  OrderType::Limit,  9990, 50);
+
+    book.addOrder(Side::Buy,  OrderType::Market, 0, 60);   // 50@10000, 10@10002
+    book.addOrder(Side::Sell, OrderType::Limit, 9990, 5);   // 5@9990
+
+    auto s = book.tradeStats().snapshot();
+    EXPECT_EQ(s.trades, 4);
+    EXPECT_EQ(s.volume, 65);
+    EXPECT_EQ(s.notional, 50 * 10000 + 10 * 10002 + 5 * 9990);
+    EXPECT_EQ(s.open, 10000);
+    EXPECT_EQ(s.high, 10002);
+    EXPECT_EQ(s.low, 9990);
+    EXPECT_EQ(s.lastPrice, 9990);
+    EXPECT_DOUBLE_EQ(s.vwap(), static_cast<double>(s.notional) / 65);
+
+    // Both aggressive orders land in the same one-second bar (or two, if the
+    // clock crossed a boundary); either way the bars add up to the session
+    ASSERT_GE(s.numBars, 1);
+    uint64_t barVolume = 0;
+    for (size_t i = 0; i < s.numBars; ++i) barVolume += s.bars[i].volume;
+    EXPECT_EQ(barVolume, 65);
+    EXPECT_EQ(s.bars[s.numBars - 1].close, 9990);
+}
+
+// Driven with explicit timestamps so bucket boundaries do not depend on the
+// clock's resolution or on when the test happens to run
+TEST(TradeStatsTest, BarsRoll) {
+    using namespace std::chrono_literals;
+    const Timestamp t0{};   // bar buckets are aligned to the clock's epoch
+    auto tally = [](Price price, Quantity qty) {
+        TradeTally t;
+        t.add(price, qty, 1);
+        return t;
+    };
+
+    TradeStats stats(1h);
+    stats.onMatchEnd(tally(10000, 10), t0 + 1min);
+    stats.onMatchEnd(tally(10000, 10), t0 + 59min);
+    EXPECT_EQ(stats.snapshot().numBars, 1);
+    stats.onMatchEnd(tally(10001, 5), t0 + 61min);
+    EXPECT_EQ(stats.snapshot().numBars, 2);
+
+    // A new interval opens a new bar on the next trade; history is bounded
+    stats.setBarInterval(1ms);
+    for (int i = 0; i < 70; ++i) {
+        stats.onMatchEnd(tally(10000 + i, 1), t0 + 2h + std::chrono::milliseconds(i));
+    }
+    auto s = stats.snapshot();
+    EXPECT_EQ(s.numBars, TRADE_BAR_HISTORY);
+    EXPECT_EQ(s.volume, 95);
+    for (size_t i = 1; i < s.numBars; ++i) {
+        EXPECT_EQ(s.bars[i].start - s.bars[i - 1].start, 1'000'000);
+    }
+    const TradeBar& last = s.bars[s.numBars - 1];
+    EXPECT_EQ(last.start, std::chrono::nanoseconds(2h + 69ms).count());
+    EXPECT_EQ(last.volume, 1);
+    EXPECT_EQ(last.close, 10069);
+
+    // A zero interval is clamped to 1 ns rather than dividing by zero
+    TradeStats zero(0ns);
+    EXPECT_EQ(zero.barInterval(), 1ns);
+    zero.onMatchEnd(tally(10000, 1), t0 + 5ns);
+    EXPECT_EQ(zero.snapshot().bars[0].start, 5);
+}
+
+TEST(TradeStatsTest, SnapshotFromAnotherThreadIsConsistent) {
+    OrderBook book(1 << 16);
+    book.setBarInterval(std::chrono::microseconds(50));
+    std::atomic<bool> done{false};
+    bool consistent = true;
+
+    std::thread reader([&] {
+        while (!done.load(std::memory_order_acquire)) {
+            auto s = book.tradeStats().snapshot();
+            if (s.trades == 0) continue;
+            // Every trade is 1 lot at 10000 or 10001
+            uint64_t barVolume = 0;
+            for (size_t i = 0; i < s.numBars; ++i) barVolume += s.bars[i].volume;
+            if (s.volume != s.trades || s.low < 10000 || s.high > 10001 ||
+                s.notional < static_cast<int64_t>(s.volume) * 10000 ||
+                s.notional > static_cast<int64_t>(s.volume) * 10001 ||
+                (s.numBars < TRADE_BAR_HISTORY && barVolume != s.volume)) {
+                consistent = false;
+            }
+        }
+    });
+
+    for (int i = 0; i < 50'000; ++i) {
+        Price p = 10000 + i % 2;
+        book.addOrder(Side::Sell, OrderType::Limit, p, 1);
+        book.addOrder(Side::Buy, OrderType::Limit, p, 1);
+    }
+    done.store(true, std::memory_order_release);
+    reader.join();
+
+    EXPECT_TRUE(consistent);
+    EXPECT_EQ(book.tradeStats().snapshot().trades, 50'000);
+}
+
+namespace {
+
+struct SelfTradeLog {
+    OrderId  orderId;
+    Quantity quantity;
+    Quantity leaves;
+};
+
+void logSelfTrade(void* ctx, OrderId id, Quantity quantity, Quantity leaves) {
+    static_cast<std::vector<SelfTradeLog>*>(ctx)->push_back({id, quantity, leaves});
+}
+
+} // namespace
+
+TEST_F(OrderBookTest, SelfTradeCancelResting) {
+    std::vector<SelfTradeLog> log;
+    book.setSelfTradeHandler(&logSelfTrade, &log);
+    constexpr OwnerId A = 1, B = 2;
+    book.addOrder(Side::Sell, OrderType::Limit, 10000, 10, B);
+    auto own = book.addOrder(Side::Sell, OrderType::Limit, 10000, 20, A);
+    book.addOrder(Side::Sell, OrderType::Limit, 10001, 30, B);
+
+    // Trades with B, skips its own order (cancelled), continues to the next level
+    auto r = book.addOrder(Side::Buy, OrderType::Limit, 10001, 25, A);
+    ASSERT_EQ(r.fills.size(), 2);
+    EXPECT_EQ(r.fills[0].quantity, 10);
+    EXPECT_EQ(r.fills[1].price, 10001);
+    EXPECT_EQ(r.fills[1].quantity, 15);
+    ASSERT_EQ(log.size(), 1);
+    EXPECT_EQ(log[0].orderId, own.orderId);
+    EXPECT_EQ(log[0].quantity, 20);
+    EXPECT_EQ(log[0].leaves, 0);
+    EXPECT_EQ(r.selfTradeQuantity, 0);
+    EXPECT_FALSE(book.cancelOrder(own.orderId));
+    EXPECT_EQ(book.orderCount(), 1);
+}
+
+TEST_F(OrderBookTest, SelfTradeCancelAggressorAndBoth) {
+    std::vector<SelfTradeLog> log;
+    book.setSelfTradeHandler(&logSelfTrade, &log);
+    constexpr OwnerId A = 7;
+    book.addOrder(Side::Buy, OrderType::Limit, 9999, 10);
+    auto own = book.addOrder(Side::Buy, OrderType::Limit, 9999, 40, A);
+
+    auto r = book.addOrder(Side::Sell, OrderType::Limit, 9990, 30, A,
+                           SelfTradePrevention::CancelAggressor);
+    EXPECT_EQ(r.filledQuantity, 10);
+    EXPECT_EQ(r.remainingQuantity, 0);   // nothing rests
+    EXPECT_EQ(r.selfTradeQuantity, 20);
+    EXPECT_TRUE(log.empty());
+    EXPECT_EQ(book.askLevelCount(), 0);
+    ASSERT_EQ(book.getBids(1).size(), 1);
+    EXPECT_EQ(book.getBids(1)[0].totalQuantity, 40);
+
+    r = book.addOrder(Side::Sell, OrderType::Market, 0, 5, A, SelfTradePrevention::CancelBoth);
+    EXPECT_EQ(r.filledQuantity, 0);
+    EXPECT_EQ(r.selfTradeQuantity, 5);
+    ASSERT_EQ(log.size(), 1);
+    EXPECT_EQ(log[0].orderId, own.orderId);
+    EXPECT_EQ(book.orderCount(), 0);
+    EXPECT_EQ(book.bidLevelCount(), 0);
+    EXPECT_EQ(book.tradeStats().snapshot().volume, 10);
+}
+
+TEST_F(OrderBookTest, SelfTradeDecrement) {
+    std::vector<SelfTradeLog> log;
+    book.setSelfTradeHandler(&logSelfTrade, &log);
+    constexpr OwnerId A = 3;
+    auto own = book.addOrder(Side::Sell, OrderType::Limit, 10000, 50, A);
+    book.addOrder(Side::Sell, OrderType::Limit, 10000, 50, A + 1);
+
+    // Smaller aggressor: both reduced by 20, aggressor done, no trade
+    auto r = book.addOrder(Side::Buy, OrderType::Limit, 10000, 20, A, SelfTradePrevention::Decrement);
+    EXPECT_TRUE(r.fills.empty());
+    EXPECT_EQ(r.selfTradeQuantity, 20);
+    ASSERT_EQ(log.size(), 1);
+    EXPECT_EQ(log[0].leaves, 30);
+    EXPECT_EQ(book.getAsks(1)[0].totalQuantity, 80);
+
+    // Larger aggressor: own order decremented away, the rest trades with A + 1
+    r = book.addOrder(Side::Buy, OrderType::Limit, 10000, 45, A, SelfTradePrevention::Decrement);
+    EXPECT_EQ(r.selfTradeQuantity, 30);
+    EXPECT_EQ(r.filledQuantity, 15);
+    EXPECT_FALSE(book.cancelOrder(own.orderId));
+    EXPECT_EQ(book.getAsks(1)[0].totalQuantity, 35);
+    EXPECT_EQ(book.tradeStats().snapshot().trades, 1);
+
+    // No owner never self-trades
+    book.addOrder(Side::Sell, OrderType::Limit, 10000, 5);
+    r = book.addOrder(Side::Buy, OrderType::Market, 0, 40);
+    EXPECT_EQ(r.filledQuantity, 40);
+    EXPECT_EQ(r.selfTradeQuantity, 0);
+}
+
+class PagedOrderBookTest : public ::testing::Test {
+protected:
+    PagedOrderBook book{4096};
+};
+
+TEST_F(PagedOrderBookTest, WideRangePrices) {
+    book.addOrder(Side::Buy,  OrderType::Limit,       100, 10);
+    book.addOrder(Side::Buy,  OrderType::Limit, 5'000'000, 20);
+    book.addOrder(Side::Sell, OrderType::Limit, 9'000'000, 30);
+    book.addOrder(Side::Sell, OrderType::Limit, PagedOrderBook::kMaxPrice, 40);
+
+    auto bids = book.getBids(10);
+    ASSERT_EQ(bids.size(), 2);
+    EXPECT_EQ(bids[0].price, 5'000'000);
+    EXPECT_EQ(bids[1].price, 100);
+
+    auto asks = book.getAsks(10);
+    ASSERT_EQ(asks.size(), 2);
+    EXPECT_EQ(asks[0].price, 9'000'000);
+    EXPECT_EQ(asks[1].price, PagedOrderBook::kMaxPrice);
+}
+
+TEST_F(PagedOrderBookTest, SweepAcrossPages) {
+    book.addOrder(Side::Sell, OrderType::Limit, 1'000'000, 50);
+    book.addOrder(Side::Sell, OrderType::Limit, 1'000'511, 50);
+    book.addOrder(Side::Sell, OrderType::Limit, 1'000'512, 50);
+    book.addOrder(Side::Sell, OrderType::Limit, 3'000'000, 50);
+
+    auto est = book.estimateBuy(160);
+    EXPECT_EQ(est.levelsSwept, 4);
+    EXPECT_EQ(est.worstPrice, 3'000'000);
+    EXPECT_EQ(book.askQuantityWithin(512), 150);
+
+    auto result = book.addOrder(Side::Buy, OrderType::Market, 0, 160);
+    EXPECT_EQ(result.filledQuantity, 160);
+    ASSERT_EQ(result.fills.size(), 4);
+    EXPECT_EQ(result.fills[2].price, 1'000'512);
+    EXPECT_EQ(result.fills[3].price, 3'000'000);
+
+    auto asks = book.getAsks(10);
+    ASSERT_EQ(asks.size(), 1);
+    EXPECT_EQ(asks[0].price, 3'000'000);
+    EXPECT_EQ(asks[0].totalQuantity, 40);
+}
+
+TEST_F(PagedOrderBookTest, LevelTotalOf2To32) {
+    constexpr Quantity kHalf = Quantity{1} << 31;
+    book.addOrder(Side::Buy, OrderType::Limit, 4'000'000, kHalf);
+    book.addOrder(Side::Buy, OrderType::Limit, 4'000'000, kHalf);
+    book.addOrder(Side::Buy, OrderType::Limit, 4'000'100, 10);
+    book.addOrder(Side::Sell, OrderType::Market, 0, 10);
+
+    auto bids = book.getBids(10);
+    ASSERT_EQ(bids.size(), 1);
+    EXPECT_EQ(bids[0].price, 4'000'000);
+
+    auto result = book.addOrder(Side::Sell, OrderType::Limit, 3'999'000, 100);
+    EXPECT_EQ(result.filledQuantity, 100);
+    EXPECT_EQ(book.askLevelCount(), 0);
+}
+
+TEST_F(PagedOrderBookTest, EmptyPagesAreReleased) {
+    size_t baseline = book.levelMemoryBytes();
+
+    auto r1 = book.addOrder(Side::Buy, OrderType::Limit, 2'000'000, 10);
+    auto r2 = book.addOrder(Side::Buy, OrderType::Limit, 7'000'000, 10);
+    EXPECT_GT(book.levelMemoryBytes(), baseline);
+
+    book.cancelOrder(r2.orderId);
+    auto bids = book.getBids(10);
+    ASSERT_EQ(bids.size(), 1);
+    EXPECT_EQ(bids[0].price, 2'000'000);
+
+    book.cancelOrder(r1.orderId);
+    EXPECT_EQ(book.bidLevelCount(), 0);
+    EXPECT_TRUE(book.getBids(10).empty());
+
+    // Released pages are pooled and reused rather than growing the footprint
+    size_t pooled = book.levelMemoryBytes();
+    book.addOrder(Side::Buy, OrderType::Limit, 4'000'000, 10);
+    book.addOrder(Side::Buy, OrderType::Limit, 6'000'000, 10);
+    EXPECT_EQ(book.levelMemoryBytes(), pooled);
+}
+
+static_assert(std::is_empty_v<NoBookStats>, "disabled stats must carry no state");
+
+TEST(InstrumentedOrderBookTest, CountersAndHistograms) {
+    InstrumentedOrderBook book(1024);
+
+    auto r1 = book.addOrder(Side::Sell, OrderType::Limit, 10000, 10);
+    book.addOrder(Side::Sell, OrderType::Limit, 10000, 10);
+    book.addOrder(Side::Sell, OrderType::Limit, 10008, 10);
+    book.cancelOrder(r1.orderId);
+    book.cancelOrder(r1.orderId);
+
+    // Sweeps the last order at 10000, then part of 10008
+    book.addOrder(Side::Buy, OrderType::Market, 0, 15);
+
+    auto s = book.stats().snapshot();
+    EXPECT_EQ(s.adds, 4);
+    EXPECT_EQ(s.marketOrders, 1);
+    EXPECT_EQ(s.cancels, 1);
+    EXPECT_EQ(s.cancelMisses, 1);
+    EXPECT_EQ(s.matches, 1);
+    EXPECT_EQ(s.fills, 2);
+    EXPECT_EQ(s.poolHighWater, 3);
+    EXPECT_EQ(s.poolInUse, 1);
+    EXPECT_EQ(s.bestPriceScans, 1);
+
+    EXPECT_EQ(s.fillsPerMatch[BookStats::bucketOf(2)], 1);
+    EXPECT_EQ(s.levelsScanned[BookStats::bucketOf(8)], 1);    // 10000 -> 10008
+    EXPECT_EQ(s.levelDepth[BookStats::bucketOf(1)], 2);
+    EXPECT_EQ(s.levelDepth[BookStats::bucketOf(2)], 1);
+
+    // Emptying a side finds no new level: nothing is recorded
+    book.addOrder(Side::Buy, OrderType::Market, 0, 5);
+    s = book.stats().snapshot();
+    EXPECT_EQ(s.bestPriceScans, 1);
+    EXPECT_EQ(s.levelsScanned[STATS_HISTOGRAM_BUCKETS - 1], 0);
+    EXPECT_EQ(s.poolInUse, 0);
+}
+
+TEST(InstrumentedOrderBookTest, SnapshotFromAnotherThread) {
+    InstrumentedOrderBook book(1 << 16);
+    std::atomic<bool> done{false};
+    uint64_t lastSeen = 0;
+    bool monotonic = true;
+
+    std::thread reader([&] {
+        while (!done.load(std::memory_order_acquire)) {
+            uint64_t adds = book.stats().snapshot().adds;
+            if (adds < lastSeen) monotonic = false;
+            lastSeen = adds;
+        }
+    });
+
+    for (int i = 0; i < 50'000; ++i) {
+        book.addOrder(i % 2 ? Side::Buy : Side::Sell, OrderType::Limit,
+                      i % 2 ? 9000 + i % 100 : 11000 - i % 100, 10);
+    }
+    done.store(true, std::memory_order_release);
+    reader.join();
+
+    EXPECT_TRUE(monotonic);
+    EXPECT_EQ(book.stats().snapshot().adds, 50'000);
+}
+
+#ifndef _WIN32
+
+class SharedBookTest : public ::testing::Test {
+protected:
+    void TearDown() override { SharedBookSegment::remove(name); }
+
+    std::string name = "/ob_test_" + std::to_string(getpid());
+};
+
+TEST_F(SharedBookTest, WarmRestartKeepsState) {
+    OrderId early;
+    {
+        SharedBookSegment seg;
+        ASSERT_TRUE(SharedBookSegment::create(name, 1024, seg));
+        OrderBook book(std::move(seg));
+        early = book.addOrder(Side::Buy, OrderType::Limit, 9990, 40).orderId;
+        book.addOrder(Side::Buy, OrderType::Limit, 9995, 25);
+        book.addOrder(Side::Sell, OrderType::Limit, 10005, 30);
+        book.addOrder(Side::Sell, OrderType::Limit, 10005, 20);
+        book.addOrder(Side::Buy, OrderType::Market, 0, 35);   // leaves 15 at 10005
+    }
+
+    SharedBookSegment seg;
+    ASSERT_TRUE(SharedBookSegment::open(name, true, seg));
+    OrderBook book(std::move(seg));
+
+    EXPECT_EQ(book.orderCount(), 3);
+    EXPECT_EQ(book.bidLevelCount(), 2);
+    EXPECT_EQ(book.askLevelCount(), 1);
+    auto asks = book.getAsks(10);
+    ASSERT_EQ(asks.size(), 1);
+    EXPECT_EQ(asks[0].price, 10005);
+    EXPECT_EQ(asks[0].totalQuantity, 15);
+
+    // Ids continue, earlier orders can still be cancelled, FIFO is intact
+    auto r = book.addOrder(Side::Sell, OrderType::Limit, 9995, 25);
+    EXPECT_EQ(r.orderId, 6);
+    ASSERT_EQ(r.fills.size(), 1);
+    EXPECT_EQ(r.fills[0].makerOrderId, 2);
+    EXPECT_TRUE(book.cancelOrder(early));
+    EXPECT_EQ(book.bidLevelCount(), 0);
+    EXPECT_EQ(book.orderCount(), 1);
+}
+
+TEST_F(SharedBookTest, ReattachedStatsCountFromPool) {
+    {
+        SharedBookSegment seg;
+        ASSERT_TRUE(SharedBookSegment::create(name, 64, seg));
+        InstrumentedOrderBook book(std::move(seg));
+        book.addOrder(Side::Buy, OrderType::Limit, 9990, 10);
+        book.addOrder(Side::Buy, OrderType::Limit, 9991, 10);
+    }
+
+    SharedBookSegment seg;
+    ASSERT_TRUE(SharedBookSegment::open(name, true, seg));
+    InstrumentedOrderBook book(std::move(seg));
+    EXPECT_EQ(book.stats().snapshot().poolInUse, 2);
+
+    book.addOrder(Side::Sell, OrderType::Market, 0, 10);
+    auto s = book.stats().snapshot();
+    EXPECT_EQ(s.poolInUse, 1);
+    EXPECT_EQ(s.poolHighWater, 3);
+}
+
+TEST_F(SharedBookTest, SecondWriterIsRefused) {
+    SharedBookSegment seg;
+    ASSERT_TRUE(SharedBookSegment::create(name, 16, seg));
+    OrderBook book(std::move(seg));
+
+    SharedBookSegment other;
+    EXPECT_FALSE(SharedBookSegment::open(name, true, other));
+    EXPECT_TRUE(SharedBookSegment::open(name, false, other));
+}
+
+TEST_F(SharedBookTest, CreateKeepsLiveSegment) {
+    SharedBookSegment seg;
+    ASSERT_TRUE(SharedBookSegment::create(name, 16, seg));
+    auto book = std::make_unique<OrderBook>(std::move(seg));
+    book->addOrder(Side::Buy, OrderType::Limit, 9990, 10);
+
+    // The running engine keeps its segment and stays visible under the name
+    SharedBookSegment other;
+    EXPECT_FALSE(SharedBookSegment::create(name, 16, other));
+    book->addOrder(Side::Buy, OrderType::Limit, 9991, 10);
+    SharedBookView view;
+    ASSERT_TRUE(view.open(name));
+    SharedBookSnapshot snap;
+    ASSERT_TRUE(view.snapshot(10, snap));
+    EXPECT_EQ(snap.numOrders, 2);
+
+    // Once the engine is gone the segment is stale and create replaces it
+    book.reset();
+    ASSERT_TRUE(SharedBookSegment::create(name, 16, other));
+    OrderBook fresh(std::move(other));
+    EXPECT_EQ(fresh.orderCount(), 0);
+}
+
+TEST_F(SharedBookTest, AddRejectedWhenIndexCannotGrow) {
+    SharedBookSegment seg;
+    ASSERT_TRUE(SharedBookSegment::create(name, 16, seg));
+    OrderBook book(std::move(seg));
+    book.addOrder(Side::Sell, OrderType::Limit, 10000, 10);
+
+    // Cap file sizes at the segment's current size so the index (17 entries
+    // for a 16-order pool) cannot be extended
+    struct stat st{};
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(fstat(fd, &st), 0);
+    close(fd);
+    rlimit saved{};
+    ASSERT_EQ(getrlimit(RLIMIT_FSIZE, &saved), 0);
+    rlimit capped = saved;
+    capped.rlim_cur = static_cast<rlim_t>(st.st_size);
+    auto oldHandler = std::signal(SIGXFSZ, SIG_IGN);
+    ASSERT_EQ(setrlimit(RLIMIT_FSIZE, &capped), 0);
+
+    // Market sells into no bids use up ids 2..16; id 17 needs a bigger index
+    for (int i = 0; i < 15; ++i) book.addOrder(Side::Sell, OrderType::Market, 0, 1);
+    OrderResult rejected = book.addOrder(Side::Buy, OrderType::Limit, 10000, 4);
+
+    setrlimit(RLIMIT_FSIZE, &saved);
+    std::signal(SIGXFSZ, oldHandler);
+
+    EXPECT_EQ(rejected.orderId, 0);
+    EXPECT_EQ(rejected.filledQuantity, 0);
+    EXPECT_EQ(book.getAsks(1)[0].totalQuantity, 10);
+
+    // Nothing was consumed: with room again the same id is issued
+    OrderResult accepted = book.addOrder(Side::Buy, OrderType::Limit, 10000, 4);
+    EXPECT_EQ(accepted.orderId, 17);
+    EXPECT_EQ(accepted.filledQuantity, 4);
+}
+
+// Death tests run first by gtest convention; same fixture
+using SharedBookDeathTest = SharedBookTest;
+
+TEST_F(SharedBookDeathTest, BookRequiresWritableSegment) {
+    {
+        SharedBookSegment seg;
+        ASSERT_TRUE(SharedBookSegment::create(name, 64, seg));
+        OrderBook book(std::move(seg));
+        book.addOrder(Side::Buy, OrderType::Limit, 9990, 10);
+    }
+
+    SharedBookSegment readOnly;
+    ASSERT_TRUE(SharedBookSegment::open(name, false, readOnly));
+    EXPECT_TRUE(readOnly.valid());
+    EXPECT_FALSE(readOnly.writable());
+    EXPECT_DEATH({ OrderBook book(std::move(readOnly)); }, "mapped read-only");
+    EXPECT_DEATH({ OrderBook book(SharedBookSegment{}); }, "not mapped");
+}
+
+TEST_F(SharedBookTest, RestartsMatchUninterruptedBook) {
+    // Same random stream into a heap book and a shared book that is torn
+    // down and reattached every 500 operations; the pool is small so the
+    // OrderId index grows while shared
+    constexpr size_t kCapacity = 256;
+    OrderBook expected(kCapacity);
+    SharedBookSegment seg;
+    ASSERT_TRUE(SharedBookSegment::create(name, kCapacity, seg));
+    auto shared = std::make_unique<OrderBook>(std::move(seg));
+
+    std::mt19937 rng(7);
+    for (int i = 0; i < 5000; ++i) {
+        if (i % 500 == 499) {
+            shared.reset();
+            ASSERT_TRUE(SharedBookSegment::open(name, true, seg));
+            shared = std::make_unique<OrderBook>(std::move(seg));
+        }
+        if (rng() % 3 == 0 || expected.orderCount() + 1 >= kCapacity) {
+            OrderId id = 1 + rng() % static_cast<OrderId>(i + 1);
+            ASSERT_EQ(expected.cancelOrder(id), shared->cancelOrder(id));
+            continue;
+        }
+        Side side = rng() % 2 ? Side::Buy : Side::Sell;
+        OrderType type = rng() % 10 ? OrderType::Limit : OrderType::Market;
+        Price price = 9950 + static_cast<Price>(rng() % 100);
+        Quantity qty = 1 + rng() % 50;
+        auto a = expected.addOrder(side, type, price, qty);
+        auto b = shared->addOrder(side, type, price, qty);
+        ASSERT_EQ(a.orderId, b.orderId);
+        ASSERT_EQ(a.fills.size(), b.fills.size());
+        for (size_t f = 0; f < a.fills.size(); ++f) {
+            ASSERT_EQ(a.fills[f].makerOrderId, b.fills[f].makerOrderId);
+            ASSERT_EQ(a.fills[f].quantity, b.fills[f].quantity);
+        }
+    }
+
+    auto depthEq = [](const std::vector<PriceLevel>& x, const std::vector<PriceLevel>& y) {
+        return std::equal(x.begin(), x.end(), y.begin(), y.end(), [](auto& l, auto& r) {
+            return l.price == r.price && l.totalQuantity == r.totalQuantity &&
+                   l.orderCount == r.orderCount;
+        });
+    };
+    EXPECT_TRUE(depthEq(expected.getBids(100), shared->getBids(100)));
+    EXPECT_TRUE(depthEq(expected.getAsks(100), shared->getAsks(100)));
+    EXPECT_EQ(expected.orderCount(), shared->orderCount());
+}
+
+TEST_F(SharedBookTest, ViewSeesDepthWhileTrading) {
+    SharedBookSegment seg;
+    ASSERT_TRUE(SharedBookSegment::create(name, 1 << 16, seg));
+    OrderBook book(std::move(seg));
+    book.addOrder(Side::Buy, OrderType::Limit, 9990, 10);
+    book.addOrder(Side::Sell, OrderType::Limit, 10010, 10);
+
+    SharedBookView view;
+    ASSERT_TRUE(view.open(name));
+    SharedBookSnapshot snap;
+    ASSERT_TRUE(view.snapshot(5, snap));
+    EXPECT_EQ(snap.bestBid, 9990);
+    EXPECT_EQ(snap.bestAsk, 10010);
+    ASSERT_EQ(snap.bids.size(), 1);
+    EXPECT_EQ(snap.bids[0].totalQuantity, 10);
+    EXPECT_EQ(snap.poolInUse, 2);
+
+    // Orders only ever rest inside [9000, 11000]; every consistent copy
+    // must say so
+    std::atomic<bool> done{false};
+    bool consistent = true;
+    std::thread reader([&] {
+        SharedBookSnapshot s;
+        while (!done.load(std::memory_order_acquire)) {
+            if (!view.snapshot(5, s)) continue;
+            if (s.bids.size() != std::min<uint64_t>(5, s.numBidLevels)) consistent = false;
+            if (!s.bids.empty() && (s.bids[0].price != s.bestBid || s.bestBid < 9000)) consistent = false;
+        }
+    });
+    for (int i = 0; i < 20'000; ++i) {
+        book.addOrder(i % 2 ? Side::Buy : Side::Sell, OrderType::Limit,
+                      i % 2 ? 9000 + i % 1000 : 11000 - i % 1000, 10);
+    }
+    done.store(true, std::memory_order_release);
+    reader.join();
+    EXPECT_TRUE(consistent);
+}
+
+#endif
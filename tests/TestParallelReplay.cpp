@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+#include "ParallelReplay.h"
+
+#include <atomic>
+#include <vector>
+
+using namespace orderbook;
+using namespace bench;
+
+namespace {
+
+Message limit(uint32_t symbol, Side side, Price price, Quantity qty) {
+    Message m{};
+    m.type     = MessageType::AddLimit;
+    m.symbol   = symbol;
+    m.side     = side;
+    m.price    = price;
+    m.quantity = qty;
+    return m;
+}
+
+Message market(uint32_t symbol, Side side, Quantity qty) {
+    Message m{};
+    m.type     = MessageType::AddMarket;
+    m.symbol   = symbol;
+    m.side     = side;
+    m.quantity = qty;
+    return m;
+}
+
+Message cancel(uint32_t symbol, OrderId ref) {
+    Message m{};
+    m.type   = MessageType::Cancel;
+    m.symbol = symbol;
+    m.ref    = ref;
+    return m;
+}
+
+Trade trade(uint64_t sequence, uint32_t symbol, OrderId maker) {
+    return {sequence, symbol, maker, 0, 10000, 1};
+}
+
+} // namespace
+
+TEST(ParallelReplayTest, PartitionBySymbolKeepsInputOrder) {
+    std::vector<Message> messages = {
+        limit(7, Side::Sell, 10000, 5), limit(3, Side::Buy, 9990, 5), cancel(7, 1),
+        market(3, Side::Sell, 2),       limit(7, Side::Sell, 10001, 5)};
+
+    auto parts = partitionBySymbol(messages);
+    ASSERT_EQ(parts.size(), 2);
+    EXPECT_EQ(parts[0].symbol, 7);
+    EXPECT_EQ(parts[0].sequence, (std::vector<uint64_t>{0, 2, 4}));
+    EXPECT_EQ(parts[0].adds, 2);
+    EXPECT_EQ(parts[1].symbol, 3);
+    EXPECT_EQ(parts[1].sequence, (std::vector<uint64_t>{1, 3}));
+    EXPECT_EQ(parts[1].adds, 2);
+    EXPECT_EQ(parts[1].messages[1].type, MessageType::AddMarket);
+
+    EXPECT_TRUE(partitionBySymbol({}).empty());
+}
+
+TEST(ParallelReplayTest, WorkStealingRunsEveryTaskOnce) {
+    // No tasks: returns without calling the task
+    std::atomic<int> calls{0};
+    runWorkStealing({}, 4, [&](size_t) { ++calls; });
+    EXPECT_EQ(calls.load(), 0);
+
+    // One task, more threads than tasks
+    std::vector<std::atomic<int>> ran(1);
+    runWorkStealing({10}, 8, [&](size_t i) { ++ran[i]; });
+    EXPECT_EQ(ran[0].load(), 1);
+
+    // Uneven costs over more threads than tasks, and over fewer
+    for (unsigned threads : {16u, 3u}) {
+        std::vector<size_t> costs = {5, 1, 9, 9, 2, 0, 7};
+        std::vector<std::atomic<int>> count(costs.size());
+        runWorkStealing(costs, threads, [&](size_t i) { ++count[i]; });
+        for (size_t i = 0; i < costs.size(); ++i) EXPECT_EQ(count[i].load(), 1) << "task " << i;
+    }
+}
+
+TEST(ParallelReplayTest, MergeTradesOrdersBySequence) {
+    std::vector<PartitionResult> results(4);
+    // Several trades per message stay together and in partition order
+    results[0].trades = {trade(1, 0, 11), trade(1, 0, 12), trade(6, 0, 13)};
+    // results[1] is empty
+    results[2].trades = {trade(0, 2, 21), trade(4, 2, 22), trade(4, 2, 23), trade(4, 2, 24)};
+    results[3].trades = {trade(5, 3, 31)};
+
+    auto merged = mergeTrades(results);
+    std::vector<OrderId> makers;
+    for (const Trade& t : merged) makers.push_back(t.makerOrderId);
+    EXPECT_EQ(makers, (std::vector<OrderId>{21, 11, 12, 22, 23, 24, 31, 13}));
+
+    EXPECT_TRUE(mergeTrades({}).empty());
+    EXPECT_TRUE(mergeTrades(std::vector<PartitionResult>(3)).empty());
+}
+
+TEST(ParallelReplayTest, ParallelMatchesSequentialAndRejectsInvalid) {
+    std::vector<Message> messages;
+    for (uint32_t round = 0; round < 50; ++round) {
+        for (uint32_t s = 0; s < 5; ++s) {
+            messages.push_back(limit(s, Side::Sell, 10000 + round % 7, 10 + s));
+            messages.push_back(market(s, Side::Buy, 15));
+        }
+    }
+    messages.push_back(limit(2, Side::Buy, MAX_PRICE + 1, 10));
+    Message badType = limit(4, Side::Buy, 9000, 10);
+    badType.type = static_cast<MessageType>(9);
+    messages.push_back(badType);
+
+    auto parts = partitionBySymbol(messages);
+    auto sequential = replayParallel(parts, 1);
+    auto parallel   = replayParallel(parts, 4);
+
+    size_t rejected = 0;
+    for (const auto& r : parallel) rejected += r.rejected;
+    EXPECT_EQ(rejected, 2);
+
+    auto a = mergeTrades(sequential);
+    auto b = mergeTrades(parallel);
+    ASSERT_EQ(a.size(), b.size());
+    ASSERT_FALSE(a.empty());
+    for (size_t i = 0; i < a.size(); ++i) {
+        EXPECT_EQ(a[i].sequence, b[i].sequence);
+        EXPECT_EQ(a[i].makerOrderId, b[i].makerOrderId);
+        EXPECT_EQ(a[i].quantity, b[i].quantity);
+        if (i > 0) {
+            EXPECT_LE(b[i - 1].sequence, b[i].sequence);
+        }
+    }
+}
@@ -0,0 +1,93 @@
+// Read-only view of a shared-memory hosted book (see SharedBook.h). Maps the
+// segment without write access, so it cannot disturb the engine.
+//
+//   book_inspector <name> [--depth=N] [--watch=MS]
+//
+// Prints top-of-book, counts and N levels per side (default 10); with
+// --watch, refreshes every MS milliseconds until interrupted.
+
+#include "SharedBook.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+using namespace orderbook;
+
+namespace {
+
+void print(const std::string& name, const SharedBookSnapshot& s) {
+    std::cout << "Book " << name << ": " << s.numOrders << " orders, "
+              << s.numBidLevels << " bid / " << s.numAskLevels << " ask levels, pool "
+              << s.poolInUse << "/" << s.poolCapacity << ", next id " << s.nextId << "\n";
+
+    std::cout << std::setw(10) << "BidQty" << std::setw(7) << "Orders" << std::setw(9) << "Bid"
+              << " | " << std::left << std::setw(9) << "Ask" << std::right
+              << std::setw(7) << "Orders" << std::setw(10) << "AskQty" << "\n";
+    size_t rows = std::max(s.bids.size(), s.asks.size());
+    for (size_t i = 0; i < rows; ++i) {
+        if (i < s.bids.size()) {
+            const PriceLevel& b = s.bids[i];
+            std::cout << std::setw(10) << b.totalQuantity << std::setw(7) << b.orderCount
+                      << std::setw(9) << b.price;
+        } else {
+            std::cout << std::string(26, ' ');
+        }
+        std::cout << " | ";
+        if (i < s.asks.size()) {
+            const PriceLevel& a = s.asks[i];
+            std::cout << std::left << std::setw(9) << a.price << std::right
+                      << std::setw(7) << a.orderCount << std::setw(10) << a.totalQuantity;
+        }
+        std::cout << "\n";
+    }
+    std::cout << std::flush;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const char* name = nullptr;
+    size_t depth = 10;
+    long watchMs = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--depth=", 8) == 0) {
+            depth = std::strtoul(argv[i] + 8, nullptr, 10);
+        } else if (std::strncmp(argv[i], "--watch=", 8) == 0) {
+            watchMs = std::strtol(argv[i] + 8, nullptr, 10);
+        } else if (argv[i][0] != '-' && !name) {
+            name = argv[i];
+        } else {
+            name = nullptr;
+            break;
+        }
+    }
+    if (!name) {
+        std::cerr << "usage: book_inspector <name> [--depth=N] [--watch=MS]\n";
+        return 1;
+    }
+
+    SharedBookView view;
+    if (!view.open(name)) {
+        std::cerr << "cannot open shared book " << name << "\n";
+        return 1;
+    }
+
+    SharedBookSnapshot snap;
+    do {
+        if (!view.snapshot(depth, snap)) {
+            std::cerr << "book busy, no consistent snapshot\n";
+            if (watchMs <= 0) return 1;
+        } else {
+            print(name, snap);
+        }
+        if (watchMs > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(watchMs));
+            std::cout << "\n";
+        }
+    } while (watchMs > 0);
+    return 0;
+}